@@ -21,6 +21,6 @@ TARGET_DIR="$BASE_ZIP_DIR/v$NEXT_VER"
 mkdir -p "$TARGET_DIR"
 
 tar -czvf "$TARGET_DIR/assotnik_p2.tar.gz" -C "$SOURCE_DIR" \
-    main.cpp Country_Data.cpp Country_Data.hpp Time_Series.cpp Time_Series.hpp assotnik_design_p2.txt passcode.txt Makefile
+    main.cpp Country_Data.cpp Country_Data.hpp Time_Series.cpp Time_Series.hpp Buffered_Writer.cpp Buffered_Writer.hpp Task_Pool.cpp Task_Pool.hpp Command_Buffer.cpp Command_Buffer.hpp String_Table.cpp String_Table.hpp Country_Loader.cpp Country_Loader.hpp Series_Index.cpp Series_Index.hpp Country_Cache.cpp Country_Cache.hpp Data_Catalog.cpp Data_Catalog.hpp Correlation_Kernel.cpp Correlation_Kernel.hpp Resize_Policy.cpp Resize_Policy.hpp Filter_Plan.cpp Filter_Plan.hpp assotnik_design_p2.txt passcode.txt Makefile
 
 echo "Archive created in: $TARGET_DIR"
\ No newline at end of file
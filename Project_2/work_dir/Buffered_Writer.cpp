@@ -0,0 +1,147 @@
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <charconv>
+#include <cstring>
+#include "Buffered_Writer.hpp"
+
+Buffered_Writer::Buffered_Writer(std::string file_name, bool binary)
+    : BUFFER_SIZE(1 << 20),
+      buffer(nullptr),
+      last_idx(0),
+      is_good(false)
+{
+    // Opens output file, binary mode is used for the columnar format so no newline translation happens.
+    if (binary){
+        file.open(file_name, std::ios::out | std::ios::trunc | std::ios::binary);
+    } else {
+        file.open(file_name, std::ios::out | std::ios::trunc);
+    }
+    is_good = file.is_open();
+
+    // Allocates the write buffer once, every write afterwards only copies into it.
+    buffer = new char[BUFFER_SIZE];
+}
+
+/*
+* Description: Returns whether the output file was opened and every write so far succeeded.
+* Output:      bool: state of the writer.
+*/
+bool Buffered_Writer::isOpen(){
+    return is_good;
+}
+
+/*
+* Description: Makes sure there is room for length bytes in the buffer, flushing it to the file if there isn't.
+* Input:       size_t: length (number of bytes about to be written).
+*/
+void Buffered_Writer::reserve(std::size_t length){
+    if (last_idx + length > BUFFER_SIZE){
+        flush();
+    }
+}
+
+/*
+* Description: Copies bytes into the buffer. Writes larger then the whole buffer go straight to the file.
+* Input:       const char*: bytes (bytes to be written), size_t: length (number of bytes).
+*/
+void Buffered_Writer::writeBytes(const char* bytes, std::size_t length){
+    reserve(length);
+
+    if (length > BUFFER_SIZE){
+        file.write(bytes, length);
+        is_good = is_good && file.good();
+        return;
+    }
+
+    std::memcpy(buffer + last_idx, bytes, length);
+    last_idx += length;
+}
+
+/*
+* Description: Writes a single character.
+* Input:       char: c (character to be written).
+*/
+void Buffered_Writer::writeChar(char c){
+    reserve(1);
+    buffer[last_idx] = c;
+    last_idx++;
+}
+
+/*
+* Description: Writes the characters of a string, without any terminator.
+* Input:       std::string_view: str (string to be written).
+*/
+void Buffered_Writer::writeString(std::string_view str){
+    writeBytes(str.data(), str.size());
+}
+
+/*
+* Description: Formats an integer as text directly into the buffer.
+* Input:       long long: value (integer to be written).
+*/
+void Buffered_Writer::writeInt(long long value){
+    // 20 digits plus sign is the longest a 64 bit integer can be.
+    reserve(24);
+    std::to_chars_result result = std::to_chars(buffer + last_idx, buffer + BUFFER_SIZE, value);
+    last_idx = result.ptr - buffer;
+}
+
+/*
+* Description: Formats a double as text directly into the buffer, using the shortest representation that reads back to the same value.
+* Input:       double: value (number to be written).
+*/
+void Buffered_Writer::writeDouble(double value){
+    // Shortest round trip form of a double never exceeds 24 characters.
+    reserve(32);
+    std::to_chars_result result = std::to_chars(buffer + last_idx, buffer + BUFFER_SIZE, value);
+    last_idx = result.ptr - buffer;
+}
+
+/*
+* Description: Writes a 32 bit unsigned integer in native byte order (binary format).
+* Input:       uint32_t: value (integer to be written).
+*/
+void Buffered_Writer::writeUInt32(std::uint32_t value){
+    writeBytes(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+/*
+* Description: Writes a 64 bit unsigned integer in native byte order (binary format).
+* Input:       uint64_t: value (integer to be written).
+*/
+void Buffered_Writer::writeUInt64(std::uint64_t value){
+    writeBytes(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+/*
+* Description: Writes everything stored in the buffer to the file, and empties the buffer.
+* Output:      bool: true if every write so far succeeded.
+*/
+bool Buffered_Writer::flush(){
+    if (last_idx > 0){
+        file.write(buffer, last_idx);
+        last_idx = 0;
+    }
+    is_good = is_good && file.good();
+    return is_good;
+}
+
+/*
+* Description: Flushes the buffer and closes the file.
+* Output:      bool: true if every write succeeded.
+*/
+bool Buffered_Writer::close(){
+    if (!file.is_open()){
+        return is_good;
+    }
+    flush();
+    file.close();
+    is_good = is_good && !file.fail();
+    return is_good;
+}
+
+Buffered_Writer::~Buffered_Writer(){
+    close();
+    delete[] buffer;
+}
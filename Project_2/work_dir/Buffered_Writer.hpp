@@ -0,0 +1,38 @@
+#ifndef BUFFERED_WRITER_H
+#define BUFFERED_WRITER_H
+
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <cstdint>
+
+class Buffered_Writer {
+private:
+    std::size_t BUFFER_SIZE;
+
+    std::ofstream file;
+
+    char* buffer;
+    std::size_t last_idx;
+
+    bool is_good;
+
+    void reserve(std::size_t length);
+
+public:
+    Buffered_Writer(std::string file_name, bool binary);
+    ~Buffered_Writer();
+
+    bool isOpen();
+    void writeBytes(const char* bytes, std::size_t length);
+    void writeChar(char c);
+    void writeString(std::string_view str);
+    void writeInt(long long value);
+    void writeDouble(double value);
+    void writeUInt32(std::uint32_t value);
+    void writeUInt64(std::uint64_t value);
+    bool flush();
+    bool close();
+};
+
+#endif
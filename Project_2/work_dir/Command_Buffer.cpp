@@ -0,0 +1,74 @@
+#include <streambuf>
+#include <string>
+#include <cctype>
+#include <cerrno>
+#include <unistd.h>
+#include "Command_Buffer.hpp"
+
+Command_Buffer::Command_Buffer(int file_descriptor)
+    : BUFFER_SIZE(1 << 16),
+      fd(file_descriptor),
+      buffer(nullptr)
+{
+    buffer = new char[BUFFER_SIZE];
+    setg(buffer, buffer, buffer);
+}
+
+/*
+* Description: Refills the buffer once everything in it was parsed. read() returns as soon as any input is available,
+*              so this only blocks while there is nothing to run.
+* Output:      int_type: next character, eof once the input is closed.
+*/
+Command_Buffer::int_type Command_Buffer::underflow(){
+    if (gptr() < egptr()){
+        return traits_type::to_int_type(*gptr());
+    }
+
+    ssize_t count = 0;
+    do {
+        count = ::read(fd, buffer, BUFFER_SIZE);
+    } while (count < 0 && errno == EINTR);
+
+    if (count <= 0){
+        return traits_type::eof();
+    }
+    setg(buffer, buffer, buffer + count);
+    return traits_type::to_int_type(*gptr());
+}
+
+/*
+* Description: Searches the input that was already read, but not parsed yet, for the next LOAD_P2 command. Never reads more input.
+* Output:      std::string: country that command loads, "" if there is none (or its name wasn't fully read yet).
+*/
+std::string Command_Buffer::nextLoadTarget(){
+    const char* position = gptr();
+    const char* end = egptr();
+    bool load_seen = false;
+
+    while (position < end){
+        // Skips to the start of the next token.
+        while (position < end && std::isspace(static_cast<unsigned char>(*position))){
+            position++;
+        }
+        const char* token_start = position;
+        while (position < end && !std::isspace(static_cast<unsigned char>(*position))){
+            position++;
+        }
+
+        // A token running into the end of the buffer may continue in input that wasn't read yet.
+        if (position == end){
+            return "";
+        }
+
+        std::string token(token_start, position);
+        if (load_seen){
+            return token;
+        }
+        load_seen = (token == "LOAD_P2");
+    }
+    return "";
+}
+
+Command_Buffer::~Command_Buffer(){
+    delete[] buffer;
+}
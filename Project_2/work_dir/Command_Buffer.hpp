@@ -0,0 +1,27 @@
+#ifndef COMMAND_BUFFER_H
+#define COMMAND_BUFFER_H
+
+#include <streambuf>
+#include <string>
+
+// Input buffer of the command stream (stdin). Each refill takes whatever the file descriptor has ready, instead of waiting
+// for a full block, so a client that sends one command and waits for its reply is answered right away.
+// Commands that were read but not parsed yet can be searched for the next LOAD_P2, which is then prefetched.
+class Command_Buffer : public std::streambuf {
+private:
+    std::size_t BUFFER_SIZE;
+
+    int fd;
+    char* buffer;
+
+protected:
+    int_type underflow() override;
+
+public:
+    Command_Buffer(int file_descriptor);
+    ~Command_Buffer();
+
+    std::string nextLoadTarget();
+};
+
+#endif
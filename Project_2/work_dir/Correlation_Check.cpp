@@ -0,0 +1,214 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <cstdio>
+#include "Country_Data.hpp"
+#include "Correlation_Kernel.hpp"
+
+/*
+* Check and benchmark of the correlation kernel at the size CORR_MATRIX is meant for.
+*
+* Usage:       ./corr_check.out [series] [years]
+*              default:   ./corr_check.out 1500 64
+*
+* Builds a country of random series (some sparse, some constant, some without valid data), times the tiled kernel,
+* exports the matrix with CORR_MATRIX, reads the file back and compares every cell against a plain two pass Pearson
+* correlation of each pair. Prints the first mismatch and exits with 1 if there is one.
+*/
+
+/*
+* Description: Pearson correlation of two series over the years both have valid data, computed directly.
+*              NaN if they share fewer than 2 years or either is constant there (same rule as the kernel).
+*/
+double naiveCorrelation(int* years_a, double* data_a, unsigned int count_a, int* years_b, double* data_b, unsigned int count_b){
+    double* x = new double[count_a + 1];
+    double* y = new double[count_a + 1];
+    unsigned int n = 0;
+    unsigned int b = 0;
+    for (unsigned int a = 0; a < count_a; a++){
+        while (b < count_b && years_b[b] < years_a[a]){
+            b++;
+        }
+        if (b < count_b && years_b[b] == years_a[a]){
+            x[n] = data_a[a];
+            y[n] = data_b[b];
+            n++;
+        }
+    }
+
+    double r = std::nan("");
+    if (n >= 2){
+        double mean_x = 0, mean_y = 0;
+        for (unsigned int i = 0; i < n; i++){
+            mean_x += x[i];
+            mean_y += y[i];
+        }
+        mean_x /= n;
+        mean_y /= n;
+
+        double sxx = 0, syy = 0, sxy = 0;
+        for (unsigned int i = 0; i < n; i++){
+            sxx += (x[i] - mean_x) * (x[i] - mean_x);
+            syy += (y[i] - mean_y) * (y[i] - mean_y);
+            sxy += (x[i] - mean_x) * (y[i] - mean_y);
+        }
+        if (sxx > 1e-9 && syy > 1e-9){
+            r = sxy / std::sqrt(sxx * syy);
+        }
+    }
+
+    delete[] x;
+    delete[] y;
+    return r;
+}
+
+/*
+* Description: Builds one csv row (name, code, then one value per year from 1960, -1 where missing).
+*              kind 0: dense random, 1: sparse random, 2: constant, 3: no valid data.
+*/
+std::string makeRow(std::mt19937& rng, unsigned int idx, unsigned int num_years, int kind){
+    std::uniform_int_distribution<int> value(1, 99999);
+    std::uniform_int_distribution<int> coin(0, 3);
+    std::ostringstream row;
+    row << "Check series " << idx << ",CHK." << idx;
+    for (unsigned int y = 0; y < num_years; y++){
+        row << ",";
+        if (kind == 3 || (kind == 1 && coin(rng) != 0)){
+            row << -1;
+        } else if (kind == 2){
+            row << 42.5;
+        } else {
+            row << value(rng) / 100.0;
+        }
+    }
+    return row.str();
+}
+
+/*
+* Description: Splits a csv line at commas, keeping empty cells.
+*/
+unsigned int splitCells(std::string line, std::string* cells, unsigned int max_cells){
+    unsigned int count = 0;
+    std::istringstream iss(line);
+    std::string cell;
+    while (count < max_cells && std::getline(iss, cell, ',')){
+        cells[count] = cell;
+        count++;
+    }
+    // getline drops a final empty cell.
+    if (count < max_cells && !line.empty() && line.back() == ','){
+        cells[count] = "";
+        count++;
+    }
+    return count;
+}
+
+int main(int argc, char* argv[]){
+    unsigned int num_series = (argc > 1) ? std::stoul(argv[1]) : 1500;
+    unsigned int num_years = (argc > 2) ? std::stoul(argv[2]) : 64;
+    std::string file_name = "corr_check.csv";
+
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> pick_kind(0, 19);
+    // Same rows are loaded into the country (for CORR_MATRIX) and into a plain array (for the kernel and the direct computation).
+    Country_Data country;
+    Time_Series* series = new Time_Series[num_series];
+    for (unsigned int i = 0; i < num_series; i++){
+        int roll = pick_kind(rng);
+        int kind = (roll == 0) ? 3 : (roll == 1) ? 2 : (roll < 6) ? 1 : 0;
+        std::string row = makeRow(rng, i, num_years, kind);
+        std::istringstream country_row(row);
+        std::istringstream series_row(row);
+        country.addSeries(country_row);
+        series[i].load(series_row);
+    }
+
+    // Times the kernel alone, then the whole CORR_MATRIX command.
+    Correlation_Kernel kernel;
+    double* matrix = new double[static_cast<std::size_t>(num_series) * num_series];
+    auto start = std::chrono::steady_clock::now();
+    kernel.setup(series, num_series);
+    kernel.matrix(matrix);
+    auto end = std::chrono::steady_clock::now();
+    delete[] matrix;
+    std::cout << num_series << " x " << num_series << " matrix over " << kernel.getNumYears() << " years: "
+              << std::chrono::duration<double, std::milli>(end - start).count() << " ms" << std::endl;
+
+    start = std::chrono::steady_clock::now();
+    country.exportCorrelation(file_name);
+    end = std::chrono::steady_clock::now();
+    std::cout << "CORR_MATRIX export: " << std::chrono::duration<double, std::milli>(end - start).count() << " ms" << std::endl;
+
+    // Valid points of every series, for the direct computation.
+    int** years = new int*[num_series];
+    double** data = new double*[num_series];
+    unsigned int* counts = new unsigned int[num_series];
+    for (unsigned int i = 0; i < num_series; i++){
+        years[i] = new int[series[i].getLastIdx() + 1];
+        data[i] = new double[series[i].getLastIdx() + 1];
+        counts[i] = series[i].copyValidData(years[i], data[i]);
+    }
+
+    std::ifstream file(file_name);
+    std::string line;
+    std::string* cells = new std::string[num_series + 2];
+    int status = 0;
+    unsigned int num_nan = 0;
+
+    // Header: "code" then every series code in array order.
+    if (!std::getline(file, line) || splitCells(line, cells, num_series + 2) != num_series + 1 || cells[0] != "code"){
+        std::cout << "bad header" << std::endl;
+        status = 1;
+    }
+    for (unsigned int j = 0; j < num_series && status == 0; j++){
+        if (cells[j + 1] != series[j].getSeriesCode()){
+            std::cout << "header column " << j + 1 << " is " << cells[j + 1] << std::endl;
+            status = 1;
+        }
+    }
+
+    // Rows: series code then one cell per series, empty where the correlation is not defined.
+    for (unsigned int i = 0; i < num_series && status == 0; i++){
+        if (!std::getline(file, line) || splitCells(line, cells, num_series + 2) != num_series + 1
+            || cells[0] != series[i].getSeriesCode()){
+            std::cout << "bad row " << i << std::endl;
+            status = 1;
+            break;
+        }
+        for (unsigned int j = 0; j < num_series; j++){
+            double expected = naiveCorrelation(years[i], data[i], counts[i], years[j], data[j], counts[j]);
+            std::string& cell = cells[j + 1];
+            bool matches = std::isnan(expected) ? cell.empty() : (!cell.empty() && std::fabs(std::stod(cell) - expected) < 1e-9);
+            num_nan += std::isnan(expected);
+            if (!matches){
+                std::cout << "cell (" << i << "," << j << ") is '" << cell << "', expected " << expected << std::endl;
+                status = 1;
+                break;
+            }
+        }
+    }
+    if (status == 0 && std::getline(file, line) && !line.empty()){
+        std::cout << "extra row after the matrix" << std::endl;
+        status = 1;
+    }
+    if (status == 0){
+        std::cout << "all " << static_cast<std::size_t>(num_series) * num_series << " cells match (" << num_nan << " empty)" << std::endl;
+    }
+
+    for (unsigned int i = 0; i < num_series; i++){
+        delete[] years[i];
+        delete[] data[i];
+    }
+    delete[] years;
+    delete[] data;
+    delete[] counts;
+    delete[] cells;
+    delete[] series;
+    file.close();
+    std::remove(file_name.c_str());
+    return status;
+}
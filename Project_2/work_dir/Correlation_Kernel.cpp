@@ -0,0 +1,228 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <new>
+#include "Correlation_Kernel.hpp"
+#include "Task_Pool.hpp"
+
+Correlation_Kernel::Correlation_Kernel()
+    : TILE_SERIES(32),
+      YEAR_ALIGNMENT(8),
+      num_series(0),
+      num_years(0),
+      stride(0),
+      years(nullptr),
+      values(nullptr),
+      squares(nullptr),
+      masks(nullptr)
+{}
+
+/*
+* Description: Lays out the series as aligned year columns. Every series gets one row, with a column per distinct year that has
+*              valid data in any series, so the overlap of two series is where both rows have a mask of 1.
+*              Values are centered on the series mean first, which keeps the sums of the kernel small and accurate.
+* Input:       Time_Series*: series (array of series), unsigned int: count (number of series).
+*/
+void Correlation_Kernel::setup(Time_Series* series, unsigned int count){
+    release();
+    num_series = count;
+
+    // Collects every valid year of every series, then keeps each year once.
+    std::size_t total = 0;
+    for (unsigned int i = 0; i < count; i++){
+        total += series[i].getLastIdx();
+    }
+    int* all_years = new int[total + 1];
+    double* all_data = new double[total + 1];
+    std::size_t* offsets = new std::size_t[count + 1];
+    offsets[0] = 0;
+    for (unsigned int i = 0; i < count; i++){
+        offsets[i + 1] = offsets[i] + series[i].copyValidData(all_years + offsets[i], all_data + offsets[i]);
+    }
+
+    years = new int[offsets[count] + 1];
+    std::copy(all_years, all_years + offsets[count], years);
+    std::sort(years, years + offsets[count]);
+    num_years = std::unique(years, years + offsets[count]) - years;
+    stride = ((num_years + YEAR_ALIGNMENT - 1) / YEAR_ALIGNMENT) * YEAR_ALIGNMENT;
+
+    values = allocateAligned(num_series * stride);
+    squares = allocateAligned(num_series * stride);
+    masks = allocateAligned(num_series * stride);
+
+    // Each row is filled independently, so rows are spread over the task pool.
+    Task_Pool::shared().parallelFor(count, 64, [&](std::size_t begin, std::size_t end){
+        for (std::size_t i = begin; i < end; i++){
+            double* value_row = values + i * stride;
+            double* square_row = squares + i * stride;
+            double* mask_row = masks + i * stride;
+            std::fill(value_row, value_row + stride, 0.0);
+            std::fill(square_row, square_row + stride, 0.0);
+            std::fill(mask_row, mask_row + stride, 0.0);
+
+            std::size_t first = offsets[i];
+            std::size_t last = offsets[i + 1];
+            if (first == last){
+                continue;
+            }
+
+            double mean = 0;
+            for (std::size_t p = first; p < last; p++){
+                mean += all_data[p];
+            }
+            mean /= (last - first);
+
+            // Years of a series are sorted, so columns are found by walking the year list once.
+            unsigned int column = 0;
+            for (std::size_t p = first; p < last; p++){
+                while (years[column] < all_years[p]){
+                    column++;
+                }
+                double centered = all_data[p] - mean;
+                value_row[column] = centered;
+                square_row[column] = centered * centered;
+                mask_row[column] = 1.0;
+            }
+        }
+    });
+
+    delete[] all_years;
+    delete[] all_data;
+    delete[] offsets;
+}
+
+/*
+* Description: Computes the full correlation matrix. The upper triangle is split into TILE_SERIES x TILE_SERIES tiles,
+*              row blocks of tiles run on the task pool, and each result is mirrored into the lower triangle.
+* Input:       double*: out (num_series x num_series, row major). out[i][j] is the Pearson correlation of series i and j
+*              over the years both have valid data, NaN if they share fewer than 2 years or either is constant there.
+*/
+void Correlation_Kernel::matrix(double* out){
+    std::size_t num_blocks = (num_series + TILE_SERIES - 1) / TILE_SERIES;
+
+    Task_Pool::shared().parallelFor(num_blocks, 1, [&](std::size_t begin, std::size_t end){
+        for (std::size_t block = begin; block < end; block++){
+            unsigned int row_begin = block * TILE_SERIES;
+            unsigned int row_end = std::min<std::size_t>(row_begin + TILE_SERIES, num_series);
+            for (std::size_t col_begin = row_begin; col_begin < num_series; col_begin += TILE_SERIES){
+                unsigned int col_end = std::min<std::size_t>(col_begin + TILE_SERIES, num_series);
+                computeTile(row_begin, row_end, col_begin, col_end, out, num_series, 0, true);
+            }
+        }
+    });
+}
+
+/*
+* Description: Computes the correlations of one series with every series (see matrix), column tiles run on the task pool.
+* Input:       unsigned int: idx (series index), double*: out (num_series values).
+*/
+void Correlation_Kernel::row(unsigned int idx, double* out){
+    std::size_t num_blocks = (num_series + TILE_SERIES - 1) / TILE_SERIES;
+
+    Task_Pool::shared().parallelFor(num_blocks, 4, [&](std::size_t begin, std::size_t end){
+        for (std::size_t block = begin; block < end; block++){
+            unsigned int col_begin = block * TILE_SERIES;
+            unsigned int col_end = std::min<std::size_t>(col_begin + TILE_SERIES, num_series);
+            computeTile(idx, idx + 1, col_begin, col_end, out, num_series, idx, false);
+        }
+    });
+}
+
+/*
+* Description: Returns the number of year columns, i.e. distinct years with valid data.
+*/
+unsigned int Correlation_Kernel::getNumYears(){
+    return num_years;
+}
+
+/*
+* Description: Computes the correlations of a tile of rows against a tile of columns. The six sums of the pairwise Pearson formula
+*              are accumulated in a single pass over the aligned year columns, with no branches. Missing years add nothing since
+*              their value, square and mask are all 0. The sums are floating point reductions, which the compiler doesn't reorder
+*              without -ffast-math: at -O3 GCC vectorizes the loads and products but keeps each sum in order (fold-left reduction),
+*              so most of the speedup of a reordered sum is not there. The all target builds without -O, so it runs scalar.
+* Input:       row/col ranges of the tile, double*: out (output matrix), size_t: ld (row length of out),
+*              unsigned int: first_row (series stored in row 0 of out), bool: symmetric (only j >= i is computed, and out[j][i] is set too).
+*/
+void Correlation_Kernel::computeTile(unsigned int row_begin, unsigned int row_end, unsigned int col_begin, unsigned int col_end,
+                                     double* out, std::size_t ld, unsigned int first_row, bool symmetric){
+    const double not_defined = std::numeric_limits<double>::quiet_NaN();
+
+    for (unsigned int i = row_begin; i < row_end; i++){
+        const double* xi = values + i * stride;
+        const double* si = squares + i * stride;
+        const double* mi = masks + i * stride;
+
+        unsigned int first_col = (symmetric && col_begin < i) ? i : col_begin;
+        for (unsigned int j = first_col; j < col_end; j++){
+            const double* xj = values + j * stride;
+            const double* sj = squares + j * stride;
+            const double* mj = masks + j * stride;
+
+            double n = 0, sum_x = 0, sum_y = 0, sum_xx = 0, sum_yy = 0, sum_xy = 0;
+            for (std::size_t y = 0; y < stride; y++){
+                n += mi[y] * mj[y];
+                sum_x += xi[y] * mj[y];
+                sum_y += mi[y] * xj[y];
+                sum_xx += si[y] * mj[y];
+                sum_yy += mi[y] * sj[y];
+                sum_xy += xi[y] * xj[y];
+            }
+
+            double r = not_defined;
+            double var_x = n * sum_xx - sum_x * sum_x;
+            double var_y = n * sum_yy - sum_y * sum_y;
+            // Series constant over the overlap leave only rounding error in the variance, relative to its scale.
+            if (n >= 2 && var_x > 1e-12 * n * sum_xx && var_y > 1e-12 * n * sum_yy){
+                r = (n * sum_xy - sum_x * sum_y) / std::sqrt(var_x * var_y);
+                // Rounding can push a perfect correlation just past 1.
+                r = std::max(-1.0, std::min(1.0, r));
+            }
+
+            out[(i - first_row) * ld + j] = r;
+            if (symmetric){
+                out[static_cast<std::size_t>(j - first_row) * ld + i] = r;
+            }
+        }
+    }
+}
+
+/*
+* Description: Allocates an array of doubles starting on a 64 byte (cache line) boundary.
+*/
+double* Correlation_Kernel::allocateAligned(std::size_t count){
+    if (count == 0){
+        return nullptr;
+    }
+    return static_cast<double*>(::operator new[](count * sizeof(double), std::align_val_t(64)));
+}
+
+/*
+* Description: Frees an array from allocateAligned.
+*/
+void Correlation_Kernel::freeAligned(double* block){
+    if (block != nullptr){
+        ::operator delete[](block, std::align_val_t(64));
+    }
+}
+
+/*
+* Description: Frees the columns of the previous setup.
+*/
+void Correlation_Kernel::release(){
+    delete[] years;
+    freeAligned(values);
+    freeAligned(squares);
+    freeAligned(masks);
+    years = nullptr;
+    values = nullptr;
+    squares = nullptr;
+    masks = nullptr;
+    num_series = 0;
+    num_years = 0;
+    stride = 0;
+}
+
+Correlation_Kernel::~Correlation_Kernel(){
+    release();
+}
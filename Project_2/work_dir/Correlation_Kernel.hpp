@@ -0,0 +1,41 @@
+#ifndef CORRELATION_KERNEL_H
+#define CORRELATION_KERNEL_H
+
+#include <cstdint>
+#include "Time_Series.hpp"
+
+class Correlation_Kernel {
+private:
+    std::size_t TILE_SERIES;
+    std::size_t YEAR_ALIGNMENT;
+
+    unsigned int num_series;
+    unsigned int num_years;
+    // Row length of the columns below, num_years rounded up so every row starts on a 64 byte boundary.
+    std::size_t stride;
+
+    // Sorted distinct years with valid data in any series, one column each.
+    int* years;
+
+    // num_series x stride matrices: centered value (0 where missing), its square, and 1/0 for valid/missing.
+    double* values;
+    double* squares;
+    double* masks;
+
+    void release();
+    static double* allocateAligned(std::size_t count);
+    static void freeAligned(double* block);
+    void computeTile(unsigned int row_begin, unsigned int row_end, unsigned int col_begin, unsigned int col_end,
+                     double* out, std::size_t ld, unsigned int first_row, bool symmetric);
+
+public:
+    Correlation_Kernel();
+    ~Correlation_Kernel();
+
+    void setup(Time_Series* series, unsigned int count);
+    void matrix(double* out);
+    void row(unsigned int idx, double* out);
+    unsigned int getNumYears();
+};
+
+#endif
@@ -0,0 +1,292 @@
+#include <iostream>
+#include <string>
+#include <cstdio>
+#include "Country_Cache.hpp"
+#include "Data_Catalog.hpp"
+
+Country_Cache::Country_Cache()
+    : SPILL_PREFIX("spill_"),
+      newest(nullptr),
+      oldest(nullptr),
+      budget(0),
+      resident_bytes(0),
+      hits(0),
+      misses(0),
+      evictions(0),
+      spills(0),
+      failed_spills(0)
+{}
+
+/*
+* Description: Returns whether countries are cached between loads. A budget of 0 (the default) disables the cache,
+*              and LOAD_P2 reads every country again like before.
+* Output:      bool: true if the cache is in use.
+*/
+bool Country_Cache::isEnabled(){
+    return budget > 0;
+}
+
+/*
+* Description: Executes CACHE_BUDGET. Evicts countries until the loaded country and the cached ones fit in the new budget.
+*              Setting the budget to 0 drops every cached country, including spilled ones.
+* Input:       size_t: bytes (new budget), Country_Data&: country_data (loaded country, never evicted).
+*/
+void Country_Cache::setBudget(std::size_t bytes, Country_Data& country_data){
+    budget = bytes;
+    if (budget == 0){
+        clear();
+    } else {
+        enforceBudget(country_data);
+    }
+    std::cout << "success" << std::endl;
+}
+
+/*
+* Description: Executes LOAD_P2 through the cache. The loaded country is kept in the cache (with its changes) and the requested
+*              one is taken from memory, from its spill file, or read by the loader, in that order.
+* Input:       std::string: country_name (country to load), Country_Data&: country_data (object holding the loaded country),
+*              Country_Loader&: loader (reads countries that are not cached).
+*/
+void Country_Cache::load(std::string country_name, Country_Data& country_data, Country_Loader& loader){
+    if (!isEnabled()){
+        loader.load(country_name, country_data);
+        return;
+    }
+
+    // LOAD_P2 drops all snapshots, as when the country is read again. Cached copies never have any, so ROLLBACK after a
+    // reload doesn't depend on whether the country stayed in memory or was spilled (spill files don't store snapshots).
+    country_data.clearSnapshots();
+
+    // Loaded country is already the requested one, its changes are kept.
+    if (country_data.getCountryName() == country_name && !isStale(country_data)){
+        hits++;
+        std::cout << "success" << std::endl;
+        return;
+    }
+
+    park(country_data);
+
+    Cache_Entry* entry = findEntry(country_name);
+    if (entry != nullptr && !entry->spilled && isStale(*entry->country)){
+        removeEntry(entry);
+        entry = nullptr;
+    }
+
+    if (entry != nullptr && !entry->spilled){
+        hits++;
+        country_data.swap(*entry->country);
+        removeEntry(entry);
+        std::cout << "success" << std::endl;
+    } else if (entry != nullptr && country_data.readBinary(spillFileName(country_name))){
+        // Changed countries are reloaded from the spill file, the data file doesn't have their changes.
+        country_data.setFileLastYear(entry->file_last_year);
+        misses++;
+        removeEntry(entry);
+        std::cout << "success" << std::endl;
+    } else {
+        misses++;
+        if (entry != nullptr){
+            removeEntry(entry);
+        }
+        loader.load(country_name, country_data);
+    }
+
+    enforceBudget(country_data);
+}
+
+/*
+* Description: Executes CACHE_STATS, printing the counters, the number of countries in memory (loaded one included)
+*              and how many bytes they use, all on one line. CACHE_STATS COUNTS prints whether they fit in the budget instead
+*              of the byte count, which depends on the platform's type sizes.
+* Input:       Country_Data&: country_data (loaded country), bool: counts_only (true for CACHE_STATS COUNTS).
+*/
+void Country_Cache::printStats(Country_Data& country_data, bool counts_only){
+    unsigned int resident = (country_data.getCountryName() != "") ? 1 : 0;
+    unsigned int spilled = 0;
+    for (Cache_Entry* entry = newest; entry != nullptr; entry = entry->older){
+        if (entry->spilled){
+            spilled++;
+        } else {
+            resident++;
+        }
+    }
+
+    std::size_t bytes = resident_bytes + country_data.memoryUsage();
+    std::cout << "hits " << hits << " misses " << misses << " evictions " << evictions << " spills " << spills
+              << " failed_spills " << failed_spills << " resident " << resident << " spilled " << spilled;
+    if (counts_only){
+        std::cout << " within_budget " << ((!isEnabled() || bytes <= budget) ? "yes" : "no") << std::endl;
+    } else {
+        std::cout << " bytes " << bytes << " budget " << budget << std::endl;
+    }
+}
+
+/*
+* Description: Moves the loaded country into a new cache entry, leaving country_data empty. Nothing is cached if no country is loaded.
+* Input:       Country_Data&: country_data (loaded country).
+*/
+void Country_Cache::park(Country_Data& country_data){
+    std::string country_name = country_data.getCountryName();
+    if (country_name == ""){
+        return;
+    }
+
+    // Stale spill file of this country is replaced by the (newer) copy in memory.
+    Cache_Entry* stale = findEntry(country_name);
+    if (stale != nullptr){
+        removeEntry(stale);
+    }
+
+    // Country goes idle here, so spare capacity is given back before it is measured. Compacted before it moves, since the
+    // policy stays with the owner (see Country_Data::swap) and the cache entry only has the default one.
+    country_data.compact();
+
+    Cache_Entry* entry = new Cache_Entry;
+    entry->country_name = country_name;
+    entry->country = new Country_Data;
+    entry->country->swap(country_data);
+    entry->bytes = entry->country->memoryUsage();
+    entry->spilled = false;
+    entry->file_last_year = entry->country->getFileLastYear();
+    resident_bytes += entry->bytes;
+    pushNewest(entry);
+}
+
+/*
+* Description: Evicts least recently used countries until the loaded country and the cached ones fit in the budget.
+*              The loaded country itself is never evicted, even if it alone is over the budget, and neither are changed
+*              countries whose spill file can't be written.
+* Input:       Country_Data&: country_data (loaded country).
+*/
+void Country_Cache::enforceBudget(Country_Data& country_data){
+    std::size_t loaded_bytes = country_data.memoryUsage();
+
+    Cache_Entry* entry = oldest;
+    while (entry != nullptr && resident_bytes + loaded_bytes > budget){
+        Cache_Entry* newer = entry->newer;
+        if (!entry->spilled){
+            evict(entry);
+        }
+        entry = newer;
+    }
+}
+
+/*
+* Description: Frees a cached country. Countries changed since they were read are first written to their spill file,
+*              unchanged ones can be read from the data file again. If the spill file can't be written, the changed country
+*              stays in memory (over the budget) so its changes are not lost, and a warning is printed to stderr.
+* Input:       Cache_Entry*: entry (resident entry to evict).
+* Output:      bool: false if the country was kept in memory.
+*/
+bool Country_Cache::evict(Cache_Entry* entry){
+    bool keep = entry->country->isModified();
+    if (keep && !entry->country->writeBinary(spillFileName(entry->country_name))){
+        std::remove(spillFileName(entry->country_name).c_str());
+        failed_spills++;
+        std::cerr << "cannot write " << spillFileName(entry->country_name) << ", keeping " << entry->country_name
+                  << " in memory" << std::endl;
+        return false;
+    }
+
+    evictions++;
+    resident_bytes -= entry->bytes;
+    delete entry->country;
+    entry->country = nullptr;
+    entry->bytes = 0;
+
+    if (keep){
+        spills++;
+        entry->spilled = true;
+    } else {
+        unlink(entry);
+        delete entry;
+    }
+    return true;
+}
+
+/*
+* Description: Returns whether a cached country must be read again because the catalog's files changed since it was read.
+*              Changed countries are never stale, their changes would be lost.
+* Input:       Country_Data&: country (cached country).
+*/
+bool Country_Cache::isStale(Country_Data& country){
+    return !country.isModified() && country.getDataGeneration() != Data_Catalog::shared().getGeneration();
+}
+
+/*
+* Description: Returns the entry of a country, nullptr if it isn't cached.
+* Input:       std::string: country_name (country to find).
+*/
+Cache_Entry* Country_Cache::findEntry(std::string country_name){
+    for (Cache_Entry* entry = newest; entry != nullptr; entry = entry->older){
+        if (entry->country_name == country_name){
+            return entry;
+        }
+    }
+    return nullptr;
+}
+
+/*
+* Description: Adds an entry at the most recently used end of the list.
+*/
+void Country_Cache::pushNewest(Cache_Entry* entry){
+    entry->newer = nullptr;
+    entry->older = newest;
+    if (newest != nullptr){
+        newest->newer = entry;
+    } else {
+        oldest = entry;
+    }
+    newest = entry;
+}
+
+/*
+* Description: Takes an entry out of the list without freeing it.
+*/
+void Country_Cache::unlink(Cache_Entry* entry){
+    if (entry->newer != nullptr){
+        entry->newer->older = entry->older;
+    } else {
+        newest = entry->older;
+    }
+    if (entry->older != nullptr){
+        entry->older->newer = entry->newer;
+    } else {
+        oldest = entry->newer;
+    }
+}
+
+/*
+* Description: Takes an entry out of the list and frees it, with its spill file. The country it holds (if any) must already
+*              be moved out or is freed too.
+*/
+void Country_Cache::removeEntry(Cache_Entry* entry){
+    unlink(entry);
+    if (entry->spilled){
+        std::remove(spillFileName(entry->country_name).c_str());
+    }
+    resident_bytes -= entry->bytes;
+    delete entry->country;
+    delete entry;
+}
+
+/*
+* Description: Frees every cached country and deletes every spill file.
+*/
+void Country_Cache::clear(){
+    while (newest != nullptr){
+        removeEntry(newest);
+    }
+    resident_bytes = 0;
+}
+
+/*
+* Description: Returns the name of the file a changed country is written to when it is evicted.
+*/
+std::string Country_Cache::spillFileName(std::string country_name){
+    return SPILL_PREFIX + country_name + ".bin";
+}
+
+Country_Cache::~Country_Cache(){
+    clear();
+}
@@ -0,0 +1,59 @@
+#ifndef COUNTRY_CACHE_H
+#define COUNTRY_CACHE_H
+
+#include <string>
+#include <cstdint>
+#include "Country_Data.hpp"
+#include "Country_Loader.hpp"
+
+// Country kept by the cache. Resident entries hold the country in memory, spilled entries only name the file it was written to.
+struct Cache_Entry {
+    std::string country_name;
+    Country_Data* country;
+    std::size_t bytes;
+    bool spilled;
+    // Country_Data::getFileLastYear of a spilled country, the spill file doesn't store it.
+    int file_last_year;
+    Cache_Entry* newer;
+    Cache_Entry* older;
+};
+
+class Country_Cache {
+private:
+    std::string SPILL_PREFIX;
+
+    // Entries from most (newest) to least (oldest) recently used. The loaded country is not in the list.
+    Cache_Entry* newest;
+    Cache_Entry* oldest;
+
+    std::size_t budget;
+    std::size_t resident_bytes;
+
+    std::uint64_t hits;
+    std::uint64_t misses;
+    std::uint64_t evictions;
+    std::uint64_t spills;
+    std::uint64_t failed_spills;
+
+    Cache_Entry* findEntry(std::string country_name);
+    void pushNewest(Cache_Entry* entry);
+    void unlink(Cache_Entry* entry);
+    void removeEntry(Cache_Entry* entry);
+    void park(Country_Data& country_data);
+    bool evict(Cache_Entry* entry);
+    void enforceBudget(Country_Data& country_data);
+    void clear();
+    bool isStale(Country_Data& country);
+    std::string spillFileName(std::string country_name);
+
+public:
+    Country_Cache();
+    ~Country_Cache();
+
+    bool isEnabled();
+    void setBudget(std::size_t bytes, Country_Data& country_data);
+    void load(std::string country_name, Country_Data& country_data, Country_Loader& loader);
+    void printStats(Country_Data& country_data, bool counts_only);
+};
+
+#endif
@@ -3,35 +3,57 @@
 #include <string>
 #include <sstream>
 #include <cassert>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+#include <climits>
 #include "Country_Data.hpp"
 #include "Time_Series.hpp"
+#include "Correlation_Kernel.hpp"
+#include "Filter_Plan.hpp"
 
 Country_Data::Country_Data():
     MIN_ARRAY_SIZE(2),
-    DATA_FILE_NAME("lab2_multidata.csv"),
+    SCAN_GRAIN(64),
     country_name(""),
     country_code(""),
     country_data(nullptr),
     array_size(0),
-    last_idx(0)
+    last_idx(0),
+    snapshots(nullptr),
+    is_modified(false),
+    data_generation(0),
+    file_last_year(INT_MIN),
+    policy(Resize_Policy::standard()),
+    index_generation(0),
+    list_cache(""),
+    list_cache_valid(false)
 {}
 
 /*
-* Description: Load csv file series data for a country.
-*              Loads every line of time series data associated with a country.
+* Description: Load csv file series data for a country, and prints success.
 * Input:       std::string: c_name (name of country)
 */
 void Country_Data::load(std::string c_name){
-    // Deallocates country_data array to prevent memory leaks.
+    readCountry(c_name);
+    std::cout << "success" << std::endl;
+}
+
+/*
+* Description: Load csv file series data for a country, without printing anything (so it can also run on a background thread).
+*              Loads every line of time series data associated with a country, from every file of the catalog (see Data_Catalog).
+* Input:       std::string: c_name (name of country)
+*/
+void Country_Data::readCountry(std::string c_name){
+    // Deallocates country_data array and snapshots of the previous country to prevent memory leaks.
+    clearSnapshots();
     delete[] country_data;
     country_data = nullptr;
     country_name = c_name;
     country_code = "";
-
-    // Creates new file stream/string variables which will be used to read from file/stored important data.
-    std::ifstream file(DATA_FILE_NAME);
-    std::string line;
-    std::string name = "";
+    list_cache_valid = false;
+    is_modified = false;
+    file_last_year = INT_MIN;
 
     // Resets array capacity/size variables
     last_idx = 0;
@@ -40,41 +62,164 @@ void Country_Data::load(std::string c_name){
     // Allocates new array of Time_Series objects which will store all of the data.
     country_data = new Time_Series[array_size];
 
-    // Loops until the first series with the correct country name is found.
-    while (std::getline(file, line)){
-        std::istringstream iss(line);
+    // Rows of the country can be spread over several files, and over several runs within a file.
+    File_Range* ranges = nullptr;
+    unsigned int num_ranges = Data_Catalog::shared().findRanges(country_name, ranges, data_generation);
+    if (num_ranges == 0){
+        return;
+    }
+
+    readRanges(ranges, num_ranges, false);
+    delete[] ranges;
+}
+
+/*
+* Description: Executes REFRESH. Reads only the rows appended to the data files since the country was read, and adds them to the
+*              loaded series: rows of new series are added as series, rows of existing series add the years after the last year
+*              column read before that the series has no valid data for (see Time_Series::mergeFileYears). Changes made to the
+*              loaded series are kept, including years added past the end in memory.
+*              Files that were rewritten instead of appended to are indexed again, and all their rows are merged the same way.
+* Output:      Prints success, or failure if no country is loaded.
+*/
+void Country_Data::refresh(){
+    if (country_name == ""){
+        std::cout << "failure" << std::endl;
+        return;
+    }
+
+    File_Range* ranges = nullptr;
+    unsigned int num_ranges = Data_Catalog::shared().refresh(country_name, ranges, data_generation);
+    if (num_ranges > 0){
+        readRanges(ranges, num_ranges, true);
+    }
+    delete[] ranges;
+    std::cout << "success" << std::endl;
+}
 
-        std::getline(iss, name, ',');
-        // Checks if series name is equal to the country name, if it is then save country code, add the series and break the loop.
-        if (name == country_name){
-            std::getline(iss, country_code, ',');
-            
-            // Add series object to the class array.
-            addSeries(iss);
-            break;
+/*
+* Description: Reads ranges of rows of the country and adds their series. Ranges are parsed concurrently, each into its own array,
+*              then added in file order so series keep their order. A row whose code is already loaded (repeated anywhere: in
+*              the same range, a later range or another file, e.g. appended with a new year column) is merged into the loaded
+*              series instead of being added twice: while loading, every year it is missing is merged, on a refresh only years
+*              after file_last_year.
+* Input:       File_Range*: ranges, unsigned int: num_ranges, bool: refreshing (true for REFRESH, false when the country is empty).
+*/
+void Country_Data::readRanges(File_Range* ranges, unsigned int num_ranges, bool refreshing){
+    Range_Series* parsed = new Range_Series[num_ranges];
+    Task_Pool::shared().parallelFor(num_ranges, 1, [&](std::size_t begin, std::size_t end){
+        for (std::size_t r = begin; r < end; r++){
+            readRange(ranges[r], parsed[r]);
         }
+    });
+
+    // Index of the loaded series of every code, by string table id (-1 if none), same as Series_Index marks seen codes.
+    // Codes of the parsed rows are interned already, so every id is below the table size.
+    std::size_t num_ids = String_Table::global().size();
+    int* series_of_code = new int[num_ids + 1];
+    for (std::size_t id = 0; id < num_ids; id++){
+        series_of_code[id] = -1;
+    }
+    for (unsigned int j = 0; j < last_idx; j++){
+        series_of_code[country_data[j].getSeriesCodeId()] = j;
     }
 
-    // Loops until the first series with the incorrect country name is found.
-    while (std::getline(file, line)){
+    int after_year = refreshing ? file_last_year : INT_MIN;
+    for (unsigned int r = 0; r < num_ranges; r++){
+        // Country code is taken from the first row of the country.
+        if (country_code == "" && parsed[r].last_idx > 0){
+            country_code = parsed[r].country_code;
+        }
+        for (unsigned int i = 0; i < parsed[r].last_idx; i++){
+            std::uint32_t code_id = parsed[r].series[i].getSeriesCodeId();
+            int series_idx = series_of_code[code_id];
+
+            file_last_year = std::max(file_last_year, parsed[r].series[i].getLastYear());
+            if (series_idx == -1){
+                appendSeries(parsed[r].series[i]);
+                series_of_code[code_id] = last_idx - 1;
+            } else {
+                country_data[series_idx].mergeFileYears(parsed[r].series[i], after_year);
+            }
+        }
+        delete[] parsed[r].series;
+    }
+    delete[] series_of_code;
+    delete[] parsed;
+}
+
+/*
+* Description: Reads the rows of one range of a data file into series. Doesn't touch the object, so ranges can be read in parallel.
+* Input:       File_Range&: range (rows to read), Range_Series&: parsed (receives the series and the country code of the rows).
+*/
+void Country_Data::readRange(File_Range& range, Range_Series& parsed){
+    parsed.series = nullptr;
+    parsed.array_size = 0;
+    parsed.last_idx = 0;
+
+    // Whole range is read with a single call, then split into rows.
+    std::ifstream file(range.file_name, std::ios::in | std::ios::binary);
+    std::string bytes(range.end - range.begin, '\0');
+    file.seekg(range.begin);
+    file.read(&bytes[0], bytes.size());
+    bytes.resize(file.gcount());
+
+    std::istringstream rows(bytes);
+    std::string line;
+    while (std::getline(rows, line)){
         std::istringstream iss(line);
 
-        std::getline(iss, name, ',');
-        
-        // Checks if series name is equal to the country name, if it isnt then break the loop.
-        if (name != country_name){
-            break;
+        // Country name is known already, country code is read for the first row only.
+        iss.ignore(std::numeric_limits<std::streamsize>::max(), ',');
+        if (parsed.last_idx == 0){
+            std::getline(iss, parsed.country_code, ',');
+        } else {
+            iss.ignore(std::numeric_limits<std::streamsize>::max(), ',');
         }
 
-        std::getline(iss, country_code, ',');
-        
-        // Add series object to the class array.
-        addSeries(iss);
+        // Grows the array by doubling, same as the country array.
+        if (parsed.last_idx >= parsed.array_size){
+            std::size_t new_size = (parsed.array_size == 0) ? 16 : parsed.array_size * 2;
+            Time_Series* temp = new Time_Series[new_size];
+            for (unsigned int i = 0; i < parsed.last_idx; i++){
+                temp[i] = parsed.series[i];
+            }
+            delete[] parsed.series;
+            parsed.series = temp;
+            parsed.array_size = new_size;
+        }
+        parsed.series[parsed.last_idx].load(iss);
+        parsed.last_idx++;
     }
+}
+
+/*
+* Description: Exchanges the loaded country (series, snapshots, capacities) with another object. Only pointers are exchanged.
+* Input:       Country_Data&: other (object to exchange contents with).
+*/
+void Country_Data::swap(Country_Data& other){
+    std::swap(country_name, other.country_name);
+    std::swap(country_code, other.country_code);
+    std::swap(country_data, other.country_data);
+    std::swap(array_size, other.array_size);
+    std::swap(last_idx, other.last_idx);
+    std::swap(snapshots, other.snapshots);
+    std::swap(is_modified, other.is_modified);
+    std::swap(data_generation, other.data_generation);
+    std::swap(file_last_year, other.file_last_year);
+    std::swap(list_cache, other.list_cache);
+    std::swap(list_cache_valid, other.list_cache_valid);
 
-    file.close();
+    // Resize policy belongs to the object, not the country, so each side's series switch to the policy of their new owner.
+    applyPolicy();
+    other.applyPolicy();
+}
 
-    std::cout << "success" << std::endl;
+/*
+* Description: Returns the name of the loaded country.
+* Output:      std::string: country name.
+*/
+std::string Country_Data::getCountryName(){
+    return country_name;
 }
 
 
@@ -83,32 +228,48 @@ void Country_Data::load(std::string c_name){
 * Input:       std::istringstream&: series (the line of data read from the csv file, which will then be processed by the load method of the Time_Series class, thus saving data into the object).
 */
 void Country_Data::addSeries(std::istringstream& series){
-    // Checks if array needs to be resized or not before addign new element.
-    checkAndResizeArray();
-
     // Declares new Time_Series variable, and calls the laod method on it thus loading all the data into it.
     Time_Series tseries;
     tseries.load(series);
+    appendSeries(tseries);
+}
+
+/*
+* Description: Adds a loaded series at the end of the country's series array.
+* Input:       Time_Series&: tseries (series to add, its arrays are shared with the copy in the array).
+*/
+void Country_Data::appendSeries(Time_Series& tseries){
+    // Checks if array needs to be resized or not before addign new element.
+    checkAndResizeArray();
 
     // Adds time series object into the country_data array.
     country_data[last_idx] = tseries;
+    country_data[last_idx].setPolicy(policy);
 
     // Increases array size.
     last_idx++;
+    list_cache_valid = false;
 }
 
 /*
 * Description: List all the series, preceded by country name and country code.
 */
 void Country_Data::listSeries(){
-    // Print country name and country code.
-    std::cout << country_name << " " << country_code;
+    // Rebuilds the line only after series were added, deleted or the country changed, otherwise it is printed with a single write.
+    if (!list_cache_valid){
+        // Country name and country code.
+        list_cache = country_name + " " + country_code;
 
-    // Loops through array of time series, and print out their names.
-    for (unsigned int i = 0; i < last_idx; i++){
-        std::cout << " " << country_data[i].getSeriesName();
+        // Loops through array of time series, and adds their names.
+        for (unsigned int i = 0; i < last_idx; i++){
+            list_cache += " ";
+            list_cache += country_data[i].getSeriesName();
+        }
+        list_cache_valid = true;
     }
-    std::cout << "" << std::endl;
+
+    std::cout.write(list_cache.data(), list_cache.size());
+    std::cout << std::endl;
 }
 
 /*
@@ -121,8 +282,9 @@ void Country_Data::addSeriesElement(std::string series_code, int year, double da
     // Check if series idx is less then zero (print failure if it is, otherwise add it to series).
     if (seriesIdx < 0){
         std::cout << "failure" << std::endl;
-    } else {
-        country_data[seriesIdx].add(year, datum);
+    } else if (country_data[seriesIdx].add(year, datum)){
+        // Only commands that changed a series mark the country, failed ones don't force a spill on eviction.
+        is_modified = true;
     }
 }
 
@@ -145,9 +307,65 @@ void Country_Data::update(std::string series_code, int year, double datum){
     // Checks if series in array, if it is then calls the update method on it.
     if (seriesIdx < 0){
         std::cout << "failure" << std::endl;
+    } else if (country_data[seriesIdx].update(year, datum)){
+        is_modified = true;
+    }
+}
+
+/*
+* Description: Applies a batch of (year, datum) pairs to one series, as BULK_ADD (is_update false) or BULK_UPDATE (is_update true).
+*              The whole batch is merged into the series in one pass (see Time_Series::mergeElements).
+* Input:       std::string: series_code, std::istringstream&: pairs (rest of the command line: year datum year datum ...), bool: is_update.
+* Output:      Prints success or failure for every pair, in input order, same as the matching ADD_P2/UPDATE_P2 commands would.
+*/
+void Country_Data::bulkMerge(std::string series_code, std::istringstream& pairs, bool is_update){
+    // Reads pairs into arrays, doubling them when full.
+    std::size_t capacity = MIN_ARRAY_SIZE;
+    unsigned int count = 0;
+    int* years = new int[capacity];
+    double* data = new double[capacity];
+
+    int year = 0;
+    double datum = 0;
+    while (pairs >> year >> datum){
+        if (count >= capacity){
+            int* temp_years = new int[capacity * 2];
+            double* temp_data = new double[capacity * 2];
+            for (unsigned int i = 0; i < count; i++){
+                temp_years[i] = years[i];
+                temp_data[i] = data[i];
+            }
+            delete[] years;
+            delete[] data;
+            years = temp_years;
+            data = temp_data;
+            capacity *= 2;
+        }
+        years[count] = year;
+        data[count] = datum;
+        count++;
+    }
+
+    bool* results = new bool[count];
+    int seriesIdx = returnSeriesIdx(series_code);
+
+    // Every pair fails if the series doesn't exist.
+    if (seriesIdx < 0){
+        for (unsigned int i = 0; i < count; i++){
+            results[i] = false;
+        }
     } else {
-        country_data[seriesIdx].update(year, datum);
+        country_data[seriesIdx].mergeElements(years, data, count, is_update, results);
     }
+
+    for (unsigned int i = 0; i < count; i++){
+        std::cout << (results[i] ? "success" : "failure") << std::endl;
+        is_modified = is_modified || results[i];
+    }
+
+    delete[] results;
+    delete[] data;
+    delete[] years;
 }
 
 /*
@@ -174,7 +392,6 @@ void Country_Data::printSeries(std::string series_code){
 * Input:       std::string: series_code (the series code by which the time series will be identified in the array).
 */
 void Country_Data::deleteSeries(std::string series_code){
-
     // Returns index of series in the series array, needed in order to find right series to remove.
     int seriesIdx = returnSeriesIdx(series_code);
 
@@ -189,6 +406,8 @@ void Country_Data::deleteSeries(std::string series_code){
         }
         // Decreases last_idx by 1 (decreasing array size pointer).
         last_idx--;
+        list_cache_valid = false;
+        is_modified = true;
     }
 
     // Checks if array needs to be resized or not.
@@ -208,16 +427,20 @@ void Country_Data::seriesWithBiggestMean(){
     // Set the output equal to failure as default
     std::string series_code = "failure";
 
+    // Means of every series are independent, so they are computed in parallel first, the comparisons below stay in array order.
+    double* means = new double[last_idx];
+    computeMeans(means);
+
     // Initalize the max/curr variables which will store mean values throughout the loop.
     double max;
     
-    double curr = country_data[0].mean();
+    double curr = means[0];
     
     unsigned int counter = 1;
 
     // Loops until finds the first mean that isnt zero (first series with valid data).
     while (curr == 0 && counter < last_idx){
-        curr = country_data[counter].mean();
+        curr = means[counter];
         counter++;
     }
 
@@ -225,7 +448,7 @@ void Country_Data::seriesWithBiggestMean(){
 
     // Loops through the time series array and thus finds the maximum mean value, by comparing current maximum with current mean.
     for (unsigned int i = 0; i < last_idx; i++){
-        curr = country_data[i].mean(); // Sets curr equal to current mean.
+        curr = means[i]; // Sets curr equal to current mean.
 
         // Checks if this new series mean is greater then the maximum.
         if (curr > max) {
@@ -234,10 +457,205 @@ void Country_Data::seriesWithBiggestMean(){
         }
     }
 
+    delete[] means;
+
     // Prints out the series code of the series with the largest mean.
     std::cout << series_code << std::endl;
 }
 
+/*
+* Description: Computes the mean of every series, using the shared task pool.
+* Input:       double*: means (array of at least last_idx elements, means[i] is set to the mean of series i).
+*/
+void Country_Data::computeMeans(double* means){
+    Task_Pool::shared().parallelFor(last_idx, SCAN_GRAIN, [this, means](std::size_t begin, std::size_t end){
+        for (std::size_t i = begin; i < end; i++){
+            means[i] = country_data[i].mean();
+        }
+    });
+}
+
+/*
+* Description: Computes the best fit slope of every series, using the shared task pool.
+* Input:       double*: slopes (slopes[i] is set to the slope of series i), bool*: valid (valid[i] is false if series i has no valid data).
+*/
+void Country_Data::computeSlopes(double* slopes, bool* valid){
+    Task_Pool::shared().parallelFor(last_idx, SCAN_GRAIN, [this, slopes, valid](std::size_t begin, std::size_t end){
+        double b = 0;
+        for (std::size_t i = begin; i < end; i++){
+            valid[i] = country_data[i].fitLine(slopes[i], b);
+        }
+    });
+}
+
+/*
+* Description: Prints the codes of the k series with the largest mean or best fit slope, largest first.
+*              Series without valid data are skipped. Equal values keep array order, same as BIGGEST_P2.
+* Input:       std::string: metric (MEAN or SLOPE), int: k (number of series to print).
+* Output:      Prints the series codes on one line, or failure if metric is unknown, k is not positive, or no series has valid data.
+*/
+void Country_Data::topSeries(std::string metric, int k){
+    if ((metric != "MEAN" && metric != "SLOPE") || k <= 0 || last_idx == 0){
+        std::cout << "failure" << std::endl;
+        return;
+    }
+
+    double* values = new double[last_idx];
+    bool* valid = new bool[last_idx];
+
+    if (metric == "MEAN"){
+        computeMeans(values);
+        // Mean of zero is how mean() reports a series with no valid data.
+        for (unsigned int i = 0; i < last_idx; i++){
+            valid[i] = country_data[i].hasValidData();
+        }
+    } else {
+        computeSlopes(values, valid);
+    }
+
+    // Collects candidate series.
+    unsigned int* order = new unsigned int[last_idx];
+    unsigned int num_valid = 0;
+    for (unsigned int i = 0; i < last_idx; i++){
+        if (valid[i]){
+            order[num_valid] = i;
+            num_valid++;
+        }
+    }
+
+    if (num_valid == 0){
+        std::cout << "failure" << std::endl;
+    } else {
+        unsigned int num_printed = (static_cast<unsigned int>(k) < num_valid) ? k : num_valid;
+
+        // Only the first k positions need to be sorted, ties are broken by array index to keep first-max-wins order.
+        std::partial_sort(order, order + num_printed, order + num_valid, [values](unsigned int a, unsigned int b){
+            if (values[a] != values[b]){
+                return values[a] > values[b];
+            }
+            return a < b;
+        });
+
+        for (unsigned int i = 0; i < num_printed; i++){
+            if (i > 0){
+                std::cout << " ";
+            }
+            std::cout << country_data[order[i]].getSeriesCode();
+        }
+        std::cout << std::endl;
+    }
+
+    delete[] order;
+    delete[] valid;
+    delete[] values;
+}
+
+/*
+* Description: Prints the k series most correlated with a series (largest absolute Pearson correlation first), over the years
+*              both have valid data. Pairs with fewer than 2 shared years, or constant over them, are skipped.
+*              Equal correlations keep array order.
+* Input:       std::string: series_code (series to compare against the others), int: k (number of series to print).
+* Output:      Prints (code,correlation) pairs on one line, or failure if the series doesn't exist, k is not positive,
+*              or no series has a correlation with it.
+*/
+void Country_Data::correlateSeries(std::string series_code, int k){
+    int series_idx = returnSeriesIdx(series_code);
+    if (series_idx == -1 || k <= 0){
+        std::cout << "failure" << std::endl;
+        return;
+    }
+
+    Correlation_Kernel kernel;
+    kernel.setup(country_data, last_idx);
+    double* correlations = new double[last_idx];
+    kernel.row(series_idx, correlations);
+
+    unsigned int* order = new unsigned int[last_idx];
+    unsigned int num_valid = 0;
+    for (unsigned int i = 0; i < last_idx; i++){
+        if (static_cast<int>(i) != series_idx && !std::isnan(correlations[i])){
+            order[num_valid] = i;
+            num_valid++;
+        }
+    }
+
+    if (num_valid == 0){
+        std::cout << "failure" << std::endl;
+    } else {
+        unsigned int num_printed = (static_cast<unsigned int>(k) < num_valid) ? k : num_valid;
+        std::partial_sort(order, order + num_printed, order + num_valid, [correlations](unsigned int a, unsigned int b){
+            double abs_a = std::fabs(correlations[a]);
+            double abs_b = std::fabs(correlations[b]);
+            if (abs_a != abs_b){
+                return abs_a > abs_b;
+            }
+            return a < b;
+        });
+
+        for (unsigned int i = 0; i < num_printed; i++){
+            if (i > 0){
+                std::cout << " ";
+            }
+            std::cout << "(" << country_data[order[i]].getSeriesCode() << "," << correlations[order[i]] << ")";
+        }
+        std::cout << std::endl;
+    }
+
+    delete[] order;
+    delete[] correlations;
+}
+
+/*
+* Description: Writes the Pearson correlation matrix of all series of the loaded country as csv. First row and first column
+*              are the series codes, pairs without a correlation (see correlateSeries) are left empty.
+* Input:       std::string: file_name (file to write to).
+* Output:      Prints success if the whole file was written, failure otherwise.
+*/
+void Country_Data::exportCorrelation(std::string file_name){
+    // Checked before the writer opens (and truncates) the file, so a failed export leaves an existing file alone.
+    if (last_idx == 0){
+        std::cout << "failure" << std::endl;
+        return;
+    }
+
+    Buffered_Writer writer(file_name, false);
+    if (!writer.isOpen()){
+        std::cout << "failure" << std::endl;
+        return;
+    }
+
+    Correlation_Kernel kernel;
+    kernel.setup(country_data, last_idx);
+    double* correlations = new double[static_cast<std::size_t>(last_idx) * last_idx];
+    kernel.matrix(correlations);
+
+    writer.writeString("code");
+    for (unsigned int j = 0; j < last_idx; j++){
+        writer.writeChar(',');
+        writer.writeString(country_data[j].getSeriesCode());
+    }
+    writer.writeChar('\n');
+
+    for (unsigned int i = 0; i < last_idx; i++){
+        writer.writeString(country_data[i].getSeriesCode());
+        double* row = correlations + static_cast<std::size_t>(i) * last_idx;
+        for (unsigned int j = 0; j < last_idx; j++){
+            writer.writeChar(',');
+            if (!std::isnan(row[j])){
+                writer.writeDouble(row[j]);
+            }
+        }
+        writer.writeChar('\n');
+    }
+    delete[] correlations;
+
+    if (writer.close()){
+        std::cout << "success" << std::endl;
+    } else {
+        std::cout << "failure" << std::endl;
+    }
+}
+
 /*
 * Description: Prints out the capacity/array size of series specified by series code.
 */
@@ -251,26 +669,430 @@ void Country_Data::seriesSizeCapacity(std::string series_code){
     } else {
         // Check if series has valid data, if not then prints default values of 0/2 for array size/capacity.
         if (country_data[seriesIdx].hasValidData()){
-            std::cout << "size is " <<  country_data[seriesIdx].getLastIdx() << " capacity is " <<  country_data[seriesIdx].getArraySize() << std::endl;    
+            std::cout << "size is " <<  country_data[seriesIdx].getLastIdx() << " capacity is " <<  country_data[seriesIdx].getArraySize();
         } else {
-            std::cout << "size is " << 0 << " capacity is " << 2 << std::endl;
+            std::cout << "size is " << 0 << " capacity is " << 2;
+        }
+
+        // Policy is only reported when it isn't the default, so the output stays the same as before policies existed.
+        if (policy != Resize_Policy::standard()){
+            std::cout << " policy is " << policy->getName();
         }
+        std::cout << std::endl;
     }
 }
 
 /*
 * Description: Returns index of series, specified by series_code (index inside the global country_data array).
+*              Code is looked up in the string table once, after that every series is checked with an integer compare.
 */
-int Country_Data::returnSeriesIdx(std::string series_code){
+int Country_Data::returnSeriesIdx(const std::string& series_code){
+    // A code that was never interned can't belong to any loaded series.
+    std::uint32_t code_id = String_Table::global().find(series_code);
+    if (code_id == String_Table::NOT_FOUND){
+        return -1;
+    }
+
     // Loops through the country_data array until it finds a series with a matching code, otherwise it outputs -1 if series not found.
     for (unsigned int i = 0; i < last_idx; i++){
-        if (country_data[i].getSeriesCode() == series_code){
+        if (country_data[i].getSeriesCodeId() == code_id){
             return i;
         }
     }
     return -1;
 }
 
+/*
+* Description: Exports the current (possibly modified) series of the loaded country to a file.
+*              CSV format uses the same row schema as the data file, so the output can be loaded back as a data file.
+*              BIN format is a columnar binary file (see writeBinary), which can be read back with readBinary.
+* Input:       std::string: format (CSV or BIN), std::string: file_name (file to write to).
+* Output:      Prints success if the whole file was written, failure otherwise.
+*/
+void Country_Data::exportData(std::string format, std::string file_name){
+    bool success = false;
+    if (format == "BIN"){
+        success = writeBinary(file_name);
+    } else if (format == "CSV"){
+        success = writeCSV(file_name);
+    }
+
+    if (success){
+        std::cout << "success" << std::endl;
+    } else {
+        std::cout << "failure" << std::endl;
+    }
+}
+
+/*
+* Description: Writes the loaded country as csv rows (country name, country code, then Time_Series::exportCSV).
+* Input:       std::string: file_name (file to write to).
+* Output:      bool: true if the whole file was written, false without touching the file if a series has valid data before
+*              the first csv year, which the csv schema can't hold (EXPORT BIN keeps it).
+*/
+bool Country_Data::writeCSV(std::string file_name){
+    for (unsigned int i = 0; i < last_idx; i++){
+        if (!country_data[i].fitsCSV()){
+            return false;
+        }
+    }
+
+    Buffered_Writer writer(file_name, false);
+    if (!writer.isOpen()){
+        return false;
+    }
+
+    // Every row is prefixed with the country name and code, same as the data file.
+    for (unsigned int i = 0; i < last_idx; i++){
+        writer.writeString(country_name);
+        writer.writeChar(',');
+        writer.writeString(country_code);
+        writer.writeChar(',');
+        country_data[i].exportCSV(writer);
+        writer.writeChar('\n');
+    }
+    return writer.close();
+}
+
+/*
+* Description: Writes the loaded country in binary columnar form: "TSB1", country name, country code, series count,
+*              then every series (see Time_Series::exportBinary). Strings are a 32 bit length followed by the characters.
+* Input:       std::string: file_name (file to write to).
+* Output:      bool: true if the whole file was written.
+*/
+bool Country_Data::writeBinary(std::string file_name){
+    Buffered_Writer writer(file_name, true);
+    if (!writer.isOpen()){
+        return false;
+    }
+
+    writer.writeString("TSB1");
+    writer.writeUInt32(country_name.size());
+    writer.writeString(country_name);
+    writer.writeUInt32(country_code.size());
+    writer.writeString(country_code);
+    writer.writeUInt32(last_idx);
+
+    for (unsigned int i = 0; i < last_idx; i++){
+        country_data[i].exportBinary(writer);
+    }
+    return writer.close();
+}
+
+/*
+* Description: Replaces the loaded country with one written by writeBinary. Series keep the capacity they had when written.
+* Input:       std::string: file_name (file to read).
+* Output:      bool: false if the file is missing or not in the binary format (the object is then empty).
+*/
+bool Country_Data::readBinary(std::string file_name){
+    clearSnapshots();
+    delete[] country_data;
+    country_data = nullptr;
+    country_name = "";
+    country_code = "";
+    last_idx = 0;
+    array_size = 0;
+    list_cache_valid = false;
+    is_modified = true;
+    data_generation = Data_Catalog::shared().getGeneration();
+    file_last_year = INT_MIN;
+
+    std::ifstream file(file_name, std::ios::in | std::ios::binary);
+    char magic[4];
+    std::uint32_t count = 0;
+    if (!file.read(magic, 4) || std::string(magic, 4) != "TSB1"){
+        return false;
+    }
+    if (!Time_Series::readBinaryString(file, country_name) || !Time_Series::readBinaryString(file, country_code)
+        || !file.read(reinterpret_cast<char*>(&count), sizeof(count))){
+        return false;
+    }
+
+    // Capacity doubles from the minimum until every series fits, same as when the series are added one by one.
+    array_size = MIN_ARRAY_SIZE;
+    while (array_size < count){
+        array_size *= 2;
+    }
+    country_data = new Time_Series[array_size];
+
+    for (unsigned int i = 0; i < count; i++){
+        if (!country_data[i].importBinary(file)){
+            last_idx = i;
+            return false;
+        }
+    }
+    last_idx = count;
+    applyPolicy();
+    return true;
+}
+
+/*
+* Description: Returns the number of bytes used by the loaded country: this object, its strings, the series array (whole
+*              capacity), every series (see Time_Series::memoryUsage) with the length of its name and code, and its snapshots.
+* Output:      size_t: bytes in use.
+*/
+std::size_t Country_Data::memoryUsage(){
+    std::size_t bytes = sizeof(Country_Data) + country_name.size() + country_code.size() + list_cache.size();
+    bytes += array_size * sizeof(Time_Series);
+    for (unsigned int i = 0; i < last_idx; i++){
+        bytes += country_data[i].memoryUsage();
+        // Names and codes are interned in String_Table::global(), shared by every country that has the series. Each series is
+        // charged their length, so the budget accounts for them even though evicting the country doesn't free them.
+        bytes += country_data[i].getSeriesName().size() + country_data[i].getSeriesCode().size();
+    }
+
+    // Snapshots share arrays with the live series until they diverge, so this is an upper bound.
+    for (Country_Snapshot* snap = snapshots; snap != nullptr; snap = snap->previous){
+        bytes += sizeof(Country_Snapshot) + snap->array_size * sizeof(Time_Series);
+        for (unsigned int i = 0; i < snap->last_idx; i++){
+            bytes += snap->series[i].memoryUsage();
+        }
+    }
+    return bytes;
+}
+
+/*
+* Description: Executes POLICY. Selects the resize policy of the series array and of every series, now and for countries
+*              loaded later (see Resize_Policy for the presets).
+* Input:       std::string: policy_name (default, hysteresis, lazy or compact).
+* Output:      Prints success, or failure if there is no policy with that name.
+*/
+void Country_Data::setPolicy(std::string policy_name){
+    const Resize_Policy* found = Resize_Policy::find(policy_name);
+    if (found == nullptr){
+        std::cout << "failure" << std::endl;
+        return;
+    }
+    policy = found;
+    applyPolicy();
+    std::cout << "success" << std::endl;
+}
+
+/*
+* Description: Makes every loaded series use the policy of this object.
+*/
+void Country_Data::applyPolicy(){
+    for (unsigned int i = 0; i < last_idx; i++){
+        country_data[i].setPolicy(policy);
+    }
+}
+
+/*
+* Description: Executes COMPACT (to_fit false, see compact) or SHRINK_TO_FIT (to_fit true, see shrinkToFit).
+* Input:       bool: to_fit.
+* Output:      Prints failure if no country is loaded, success otherwise.
+*/
+void Country_Data::resizeCommand(bool to_fit){
+    if (country_name == ""){
+        std::cout << "failure" << std::endl;
+        return;
+    }
+
+    if (to_fit){
+        shrinkToFit();
+    } else {
+        compact();
+    }
+    std::cout << "success" << std::endl;
+}
+
+/*
+* Description: Shrinks the series array and every series the way the policy shrinks idle arrays. Lazy policies never shrink on
+*              writes, only here. Runs when the country goes idle in the cache, or with the COMPACT command.
+* Output:      unsigned int: number of arrays that were reallocated.
+*/
+unsigned int Country_Data::compact(){
+    unsigned int resized = 0;
+    for (unsigned int i = 0; i < last_idx; i++){
+        if (country_data[i].compact()){
+            resized++;
+        }
+    }
+
+    size_t new_size = policy->idleCapacity(last_idx, array_size, MIN_ARRAY_SIZE);
+    if (country_data != nullptr && new_size != array_size){
+        resizeArray(new_size);
+        resized++;
+    }
+    return resized;
+}
+
+/*
+* Description: Executes SHRINK_TO_FIT. Shrinks the series array and every series to their sizes (at least MIN_ARRAY_SIZE).
+* Output:      unsigned int: number of arrays that were reallocated.
+*/
+unsigned int Country_Data::shrinkToFit(){
+    unsigned int resized = 0;
+    for (unsigned int i = 0; i < last_idx; i++){
+        if (country_data[i].shrinkToFit()){
+            resized++;
+        }
+    }
+
+    size_t new_size = (last_idx > static_cast<unsigned int>(MIN_ARRAY_SIZE)) ? last_idx : MIN_ARRAY_SIZE;
+    if (country_data != nullptr && new_size != array_size){
+        resizeArray(new_size);
+        resized++;
+    }
+    return resized;
+}
+
+/*
+* Description: Returns the catalog generation the loaded country was read (or last refreshed) at.
+* Output:      unsigned int: generation (see Data_Catalog::getGeneration).
+*/
+unsigned int Country_Data::getDataGeneration(){
+    return data_generation;
+}
+
+/*
+* Description: Returns the last year column read from the data files (INT_MIN if none was read, e.g. after readBinary).
+* Output:      int: year.
+*/
+int Country_Data::getFileLastYear(){
+    return file_last_year;
+}
+
+/*
+* Description: Sets the last year column read from the data files, for a country read back with readBinary.
+* Input:       int: year (see getFileLastYear).
+*/
+void Country_Data::setFileLastYear(int year){
+    file_last_year = year;
+}
+
+/*
+* Description: Returns whether the loaded series were changed since they were read from the data file.
+* Output:      bool: true if modified.
+*/
+bool Country_Data::isModified(){
+    return is_modified;
+}
+
+/*
+* Description: Searches the series of the data files. CODE takes a code, or a code prefix ending in '*' (e.g. EG.CFT.*).
+*              NAME takes one or more words, which must all appear in the series name.
+*              The index is built from the catalog's files the first time, every search after that is a binary search.
+* Input:       std::string: field (CODE or NAME), std::istringstream&: query (rest of the command line).
+* Output:      Prints matching series codes on one line, or failure.
+*/
+void Country_Data::findSeries(std::string field, std::istringstream& query){
+    if (field != "CODE" && field != "NAME"){
+        std::cout << "failure" << std::endl;
+        return;
+    }
+
+    // Index covers every file of the catalog, and is rebuilt after files are added or dropped.
+    unsigned int generation = Data_Catalog::shared().getGeneration();
+    if (!series_index.isBuilt() || index_generation != generation){
+        std::string* file_names = nullptr;
+        unsigned int num_files = Data_Catalog::shared().copyFileNames(file_names);
+        series_index.build(file_names, num_files);
+        index_generation = generation;
+        delete[] file_names;
+    }
+
+    if (field == "CODE"){
+        std::string prefix;
+        query >> prefix;
+        series_index.findCodes(prefix);
+    } else {
+        series_index.findNames(query);
+    }
+}
+
+/*
+* Description: Prints the codes of every series satisfying a predicate on its mean, min, max, best fit slope, number of valid
+*              points or value in a year (see Filter_Plan.hpp), in array order. The query is compiled once, then evaluated
+*              over all series together.
+* Input:       std::istringstream&: query (e.g. "MEAN > 5 AND MAX@1990:2000 > 10 AND SLOPE > 0").
+* Output:      Prints matching codes on one line, failure if the query is invalid or no series matches.
+*/
+void Country_Data::filterSeries(std::istringstream& query){
+    Filter_Plan plan;
+    if (!plan.compile(query)){
+        std::cout << "failure" << std::endl;
+        return;
+    }
+
+    unsigned char* matches = new unsigned char[last_idx + 1];
+    if (plan.evaluate(country_data, last_idx, matches) == 0){
+        std::cout << "failure" << std::endl;
+    } else {
+        bool first = true;
+        for (unsigned int i = 0; i < last_idx; i++){
+            if (matches[i]){
+                if (!first){
+                    std::cout << " ";
+                }
+                std::cout << country_data[i].getSeriesCode();
+                first = false;
+            }
+        }
+        std::cout << std::endl;
+    }
+
+    delete[] matches;
+}
+
+/*
+* Description: Saves the current series of the country, so a later ROLLBACK can return to it. Snapshots stack, newest on top.
+*              Only the Time_Series objects are copied, which shares their arrays, so this costs O(N) and no series data is copied.
+*              Series modified afterwards copy their own arrays on the first write.
+*/
+void Country_Data::snapshot(){
+    Country_Snapshot* snap = new Country_Snapshot;
+    snap->series = new Time_Series[array_size];
+    snap->array_size = array_size;
+    snap->last_idx = last_idx;
+    snap->previous = snapshots;
+
+    for (unsigned int i = 0; i < last_idx; i++){
+        snap->series[i] = country_data[i];
+    }
+    snapshots = snap;
+
+    std::cout << "success" << std::endl;
+}
+
+/*
+* Description: Restores the series of the country saved by the most recent SNAPSHOT, and removes that snapshot.
+* Output:      Prints failure if there is no snapshot, success otherwise.
+*/
+void Country_Data::rollback(){
+    if (snapshots == nullptr){
+        std::cout << "failure" << std::endl;
+        return;
+    }
+    is_modified = true;
+
+    Country_Snapshot* snap = snapshots;
+    snapshots = snap->previous;
+
+    // Snapshot array becomes the live array, so capacities are exactly what they were when the snapshot was taken.
+    delete[] country_data;
+    country_data = snap->series;
+    array_size = snap->array_size;
+    last_idx = snap->last_idx;
+    list_cache_valid = false;
+    delete snap;
+    applyPolicy();
+
+    std::cout << "success" << std::endl;
+}
+
+/*
+* Description: Deletes all snapshots.
+*/
+void Country_Data::clearSnapshots(){
+    while (snapshots != nullptr){
+        Country_Snapshot* previous = snapshots->previous;
+        delete[] snapshots->series;
+        delete snapshots;
+        snapshots = previous;
+    }
+}
+
 /*
 * Description: Checks class array needs to be resized. Resizes it if one of two seperate conditions are met:
 *                   If array size is less then or equal to array capacity ran out of space then resize. Return true.
@@ -278,20 +1100,12 @@ int Country_Data::returnSeriesIdx(std::string series_code){
 * Output:      bool: Whether function was resized or not.
 */
 bool Country_Data::checkAndResizeArray(){
-    bool flag = false;
-    size_t new_size = array_size;
-
-    if (last_idx >= array_size){
-        new_size = array_size * 2;
-        flag = true;
-        resizeArray(new_size);
-    } else if (last_idx <= array_size/4 && last_idx != 0){
-        new_size = array_size/2;
-        flag = true;
-        resizeArray(new_size);
+    size_t new_size = policy->nextCapacity(last_idx, array_size, MIN_ARRAY_SIZE);
+    if (new_size == array_size){
+        return false;
     }
-
-    return flag;
+    resizeArray(new_size);
+    return true;
 }
 
 /*
@@ -317,5 +1131,6 @@ void Country_Data::resizeArray(size_t& new_size){
 
 
 Country_Data::~Country_Data(){
+    clearSnapshots();
     delete[] country_data;
 }
\ No newline at end of file
@@ -6,13 +6,34 @@
 #include <string>
 #include <sstream>
 #include "Time_Series.hpp"
+#include "Buffered_Writer.hpp"
+#include "Task_Pool.hpp"
+#include "Series_Index.hpp"
+#include "Data_Catalog.hpp"
+#include "Resize_Policy.hpp"
 
 class Time_Series;
 
+// Saved state of the country's series array. Series share their arrays with the live ones until either side is modified.
+struct Country_Snapshot {
+    Time_Series* series;
+    std::size_t array_size;
+    unsigned int last_idx;
+    Country_Snapshot* previous;
+};
+
+// Series read from one range of rows, before they are added to the country.
+struct Range_Series {
+    Time_Series* series;
+    std::size_t array_size;
+    unsigned int last_idx;
+    std::string country_code;
+};
+
 class Country_Data {
 private:
-    std::string DATA_FILE_NAME;
     int MIN_ARRAY_SIZE;
+    std::size_t SCAN_GRAIN;
     std::string country_name;
     std::string country_code;
 
@@ -21,22 +42,77 @@ private:
     std::size_t array_size;
     unsigned int last_idx;
 
+    Country_Snapshot* snapshots;
+
+    // Set by any command that changes series, cleared when the country is read from the data file.
+    bool is_modified;
+
+    // Catalog generation the series were read (or refreshed) at.
+    unsigned int data_generation;
+
+    // Last year column read from the data files. REFRESH only merges file years after it (see Time_Series::mergeFileYears).
+    int file_last_year;
+
+    // Resize policy of the series array and of every series (see Resize_Policy).
+    const Resize_Policy* policy;
+
+    // Code/name search index over every data file, built on the first FIND (catalog generation it was built for).
+    Series_Index series_index;
+    unsigned int index_generation;
+
+    // Output of LIST_P2, rebuilt after the set of series changes.
+    std::string list_cache;
+    bool list_cache_valid;
+
+    void appendSeries(Time_Series& tseries);
+    void applyPolicy();
+    static void readRange(File_Range& range, Range_Series& parsed);
+    void readRanges(File_Range* ranges, unsigned int num_ranges, bool refreshing);
+
 public:
     Country_Data();
     ~Country_Data();
     
     void load(std::string country_name);
+    void readCountry(std::string country_name);
+    void swap(Country_Data& other);
+    std::string getCountryName();
     void addSeries(std::istringstream& series);
     void listSeries();
     bool checkAndResizeArray();
     void resizeArray(size_t& new_size);
     void addSeriesElement(std::string series_code, int year, double datum);
     void update(std::string series_code, int year, double datum);
+    void bulkMerge(std::string series_code, std::istringstream& pairs, bool is_update);
     void printSeries(std::string series_code);
     void deleteSeries(std::string series_code);
     void seriesWithBiggestMean();
     void seriesSizeCapacity(std::string series_code);
-    int returnSeriesIdx(std::string series_code);
+    int returnSeriesIdx(const std::string& series_code);
+    void exportData(std::string format, std::string file_name);
+    bool writeCSV(std::string file_name);
+    bool writeBinary(std::string file_name);
+    bool readBinary(std::string file_name);
+    std::size_t memoryUsage();
+    bool isModified();
+    unsigned int getDataGeneration();
+    int getFileLastYear();
+    void setFileLastYear(int year);
+    void setPolicy(std::string policy_name);
+    unsigned int compact();
+    unsigned int shrinkToFit();
+    void resizeCommand(bool to_fit);
+    void refresh();
+    void computeMeans(double* means);
+    void computeSlopes(double* slopes, bool* valid);
+    void topSeries(std::string metric, int k);
+    void correlateSeries(std::string series_code, int k);
+    void exportCorrelation(std::string file_name);
+    void findSeries(std::string field, std::istringstream& query);
+    void filterSeries(std::istringstream& query);
+    void snapshot();
+    void clearSnapshots();
+    void rollback();
 };
 
 #endif
\ No newline at end of file
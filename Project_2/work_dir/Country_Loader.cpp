@@ -0,0 +1,79 @@
+#include <iostream>
+#include <string>
+#include <thread>
+#include "Country_Loader.hpp"
+#include "Data_Catalog.hpp"
+
+Country_Loader::Country_Loader()
+    : standby(nullptr),
+      standby_name(""),
+      standby_generation(0)
+{
+    standby = new Country_Data;
+}
+
+/*
+* Description: Starts reading a country into the standby object on a background thread, so a later LOAD_P2 of it only swaps pointers.
+*              Does nothing if that country is already (being) prefetched. Waits for any other prefetch that is still running first.
+* Input:       std::string: country_name (country to read).
+* Output:      bool: false if no data file has rows of the country (nothing is read then).
+*/
+bool Country_Loader::prefetch(std::string country_name){
+    if (country_name == standby_name && standby_generation == Data_Catalog::shared().getGeneration()){
+        return true;
+    }
+
+    File_Range* ranges = nullptr;
+    unsigned int generation = 0;
+    unsigned int num_ranges = Data_Catalog::shared().findRanges(country_name, ranges, generation);
+    delete[] ranges;
+    if (num_ranges == 0){
+        return false;
+    }
+    waitForWorker();
+
+    standby_name = country_name;
+    standby_generation = Data_Catalog::shared().getGeneration();
+    Country_Data* target = standby;
+    worker = std::thread([target, country_name](){
+        target->readCountry(country_name);
+    });
+    return true;
+}
+
+/*
+* Description: Executes LOAD_P2. Uses the standby object if it holds the requested country, otherwise reads the country normally.
+*              Swapping leaves the previous country in the standby object, where it is freed by the next prefetch.
+*              A standby country read before the catalog's files changed is stale, and is read again.
+* Input:       std::string: country_name (country to load), Country_Data&: country_data (object holding the current country).
+*/
+void Country_Loader::load(std::string country_name, Country_Data& country_data){
+    if (country_name != standby_name){
+        country_data.load(country_name);
+        return;
+    }
+
+    waitForWorker();
+    if (standby->getDataGeneration() != Data_Catalog::shared().getGeneration()){
+        standby_name = "";
+        country_data.load(country_name);
+        return;
+    }
+    country_data.swap(*standby);
+    standby_name = "";
+    std::cout << "success" << std::endl;
+}
+
+/*
+* Description: Blocks until the background read (if any) has finished.
+*/
+void Country_Loader::waitForWorker(){
+    if (worker.joinable()){
+        worker.join();
+    }
+}
+
+Country_Loader::~Country_Loader(){
+    waitForWorker();
+    delete standby;
+}
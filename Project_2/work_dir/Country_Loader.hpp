@@ -0,0 +1,26 @@
+#ifndef COUNTRY_LOADER_H
+#define COUNTRY_LOADER_H
+
+#include <string>
+#include <thread>
+#include "Country_Data.hpp"
+
+class Country_Loader {
+private:
+    Country_Data* standby;
+    std::string standby_name;
+    // Catalog generation the standby country was read from, a prefetch from before files changed is not used.
+    unsigned int standby_generation;
+    std::thread worker;
+
+    void waitForWorker();
+
+public:
+    Country_Loader();
+    ~Country_Loader();
+
+    bool prefetch(std::string country_name);
+    void load(std::string country_name, Country_Data& country_data);
+};
+
+#endif
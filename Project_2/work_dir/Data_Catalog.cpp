@@ -0,0 +1,418 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <algorithm>
+#include "Data_Catalog.hpp"
+#include "String_Table.hpp"
+#include "Task_Pool.hpp"
+
+Data_Catalog::Data_Catalog()
+    : MIN_ARRAY_SIZE(2),
+      files(nullptr),
+      indexed_sizes(nullptr),
+      tails(nullptr),
+      files_size(0),
+      num_files(0),
+      indexed_files(0),
+      ranges(nullptr),
+      ranges_size(0),
+      num_ranges(0),
+      generation(0)
+{
+    // The original data file is always registered, so a program that never adds files behaves like before.
+    addFile("lab2_multidata.csv");
+}
+
+/*
+* Description: Returns the catalog shared by the whole program, which every country is read through.
+* Output:      Data_Catalog&: shared catalog.
+*/
+Data_Catalog& Data_Catalog::shared(){
+    static Data_Catalog catalog;
+    return catalog;
+}
+
+/*
+* Description: Registers a data file (shard). Its rows are indexed the next time a country is looked up.
+* Input:       std::string: file_name (csv file with the same row schema as lab2_multidata.csv).
+* Output:      bool: false if the file can't be opened or is already registered.
+*/
+bool Data_Catalog::addFile(std::string file_name){
+    std::lock_guard<std::mutex> guard(catalog_lock);
+
+    std::ifstream file(file_name);
+    if (!file.is_open()){
+        return false;
+    }
+    for (unsigned int i = 0; i < num_files; i++){
+        if (files[i] == file_name){
+            return false;
+        }
+    }
+
+    // Grows the file list by doubling, same as the other dynamic arrays.
+    if (num_files >= files_size){
+        std::size_t new_size = (files_size == 0) ? MIN_ARRAY_SIZE : files_size * 2;
+        std::string* temp_files = new std::string[new_size];
+        std::uint64_t* temp_sizes = new std::uint64_t[new_size];
+        std::string* temp_tails = new std::string[new_size];
+        for (unsigned int i = 0; i < num_files; i++){
+            temp_files[i] = files[i];
+            temp_sizes[i] = indexed_sizes[i];
+            temp_tails[i] = tails[i];
+        }
+        delete[] files;
+        delete[] indexed_sizes;
+        delete[] tails;
+        files = temp_files;
+        indexed_sizes = temp_sizes;
+        tails = temp_tails;
+        files_size = new_size;
+    }
+
+    files[num_files] = file_name;
+    indexed_sizes[num_files] = 0;
+    tails[num_files] = "";
+    num_files++;
+    generation++;
+    return true;
+}
+
+/*
+* Description: Unregisters a data file. The index is dropped and rebuilt from the remaining files on the next lookup.
+* Input:       std::string: file_name (registered file).
+* Output:      bool: false if the file isn't registered.
+*/
+bool Data_Catalog::dropFile(std::string file_name){
+    std::lock_guard<std::mutex> guard(catalog_lock);
+
+    unsigned int idx = 0;
+    while (idx < num_files && files[idx] != file_name){
+        idx++;
+    }
+    if (idx == num_files){
+        return false;
+    }
+
+    // Shifts the remaining files left to keep the list contiguous.
+    for (unsigned int i = idx; i + 1 < num_files; i++){
+        files[i] = files[i + 1];
+        tails[i] = tails[i + 1];
+    }
+    num_files--;
+
+    for (unsigned int i = 0; i < num_files; i++){
+        indexed_sizes[i] = 0;
+    }
+    indexed_files = 0;
+    num_ranges = 0;
+    generation++;
+    return true;
+}
+
+/*
+* Description: Prints the registered files, in the order their rows are read, on one line.
+*/
+void Data_Catalog::listFiles(){
+    std::lock_guard<std::mutex> guard(catalog_lock);
+
+    for (unsigned int i = 0; i < num_files; i++){
+        if (i > 0){
+            std::cout << " ";
+        }
+        std::cout << files[i];
+    }
+    std::cout << std::endl;
+}
+
+/*
+* Description: Returns every row range of a country over all registered files, indexing files that weren't indexed yet.
+*              Ranges are in file registration order, then in row order, so series keep the order they have in the files.
+* Input:       std::string: country_name (country to find), File_Range*&: found (receives an array the caller must delete[],
+*              nullptr if there are no rows), unsigned int&: found_generation (receives the generation the ranges belong to).
+* Output:      unsigned int: number of ranges.
+*/
+unsigned int Data_Catalog::findRanges(std::string country_name, File_Range*& found, unsigned int& found_generation){
+    std::lock_guard<std::mutex> guard(catalog_lock);
+    found = nullptr;
+
+    indexFiles();
+    found_generation = generation;
+
+    // Country that was never interned doesn't appear in any file.
+    std::uint32_t country_id = String_Table::global().find(country_name);
+    if (country_id == String_Table::NOT_FOUND){
+        return 0;
+    }
+
+    Row_Range key = {country_id, 0, 0, 0};
+    Row_Range* first = std::lower_bound(ranges, ranges + num_ranges, key, [](const Row_Range& a, const Row_Range& b){
+        return a.country_id < b.country_id;
+    });
+    Row_Range* last = first;
+    while (last < ranges + num_ranges && last->country_id == country_id){
+        last++;
+    }
+
+    unsigned int count = last - first;
+    if (count == 0){
+        return 0;
+    }
+    found = new File_Range[count];
+    for (unsigned int i = 0; i < count; i++){
+        found[i].file_name = files[first[i].file_idx];
+        found[i].begin = first[i].begin;
+        found[i].end = first[i].end;
+    }
+    return count;
+}
+
+/*
+* Description: Copies the names of the registered files.
+* Input:       std::string*&: names (receives an array the caller must delete[], nullptr if there are no files).
+* Output:      unsigned int: number of files.
+*/
+unsigned int Data_Catalog::copyFileNames(std::string*& names){
+    std::lock_guard<std::mutex> guard(catalog_lock);
+
+    names = (num_files > 0) ? new std::string[num_files] : nullptr;
+    for (unsigned int i = 0; i < num_files; i++){
+        names[i] = files[i];
+    }
+    return num_files;
+}
+
+/*
+* Description: Returns the current generation, which changes whenever files are added, dropped or grow.
+* Output:      unsigned int: generation.
+*/
+unsigned int Data_Catalog::getGeneration(){
+    std::lock_guard<std::mutex> guard(catalog_lock);
+    return generation;
+}
+
+/*
+* Description: Indexes files registered since the last lookup. Caller must hold catalog_lock.
+*/
+void Data_Catalog::indexFiles(){
+    if (indexed_files == num_files){
+        return;
+    }
+    scanFiles(indexed_files, true);
+    indexed_files = num_files;
+}
+
+/*
+* Description: Indexes the bytes of files [first_file, num_files) past what was indexed before. Each file is scanned on its own
+*              thread (Task_Pool), then their ranges are merged into the sorted range array. Caller must hold catalog_lock.
+* Input:       unsigned int: first_file (first file to scan), bool: include_partial (whether a last row without a line break is
+*              indexed, it may still be being written while a file grows).
+*/
+void Data_Catalog::scanFiles(unsigned int first_file, bool include_partial){
+    unsigned int count = num_files - first_file;
+    Row_Range** found = new Row_Range*[count];
+    std::size_t* found_sizes = new std::size_t[count];
+    unsigned int* num_found = new unsigned int[count];
+    std::uint64_t* file_sizes = new std::uint64_t[count];
+
+    Task_Pool::shared().parallelFor(count, 1, [&](std::size_t begin, std::size_t end){
+        for (std::size_t i = begin; i < end; i++){
+            found[i] = nullptr;
+            found_sizes[i] = 0;
+            num_found[i] = 0;
+            scanFile(files[first_file + i], first_file + i, indexed_sizes[first_file + i], include_partial,
+                     found[i], found_sizes[i], num_found[i], file_sizes[i]);
+        }
+    });
+
+    for (unsigned int i = 0; i < count; i++){
+        for (unsigned int r = 0; r < num_found[i]; r++){
+            addRange(ranges, ranges_size, num_ranges, found[i][r]);
+        }
+        indexed_sizes[first_file + i] = file_sizes[i];
+        tails[first_file + i] = readTail(files[first_file + i], file_sizes[i]);
+        delete[] found[i];
+    }
+    delete[] found;
+    delete[] found_sizes;
+    delete[] num_found;
+    delete[] file_sizes;
+
+    std::sort(ranges, ranges + num_ranges, [](const Row_Range& a, const Row_Range& b){
+        if (a.country_id != b.country_id){
+            return a.country_id < b.country_id;
+        }
+        if (a.file_idx != b.file_idx){
+            return a.file_idx < b.file_idx;
+        }
+        return a.begin < b.begin;
+    });
+}
+
+/*
+* Description: Indexes rows appended to the files since they were last indexed, and returns the new row ranges of one country.
+*              Files registered since the last lookup are new as a whole. A file that shrank, or whose indexed bytes changed
+*              (e.g. rewritten with a new year column), is indexed again from the start, and every range of the country is returned.
+* Input:       std::string: country_name (country to return ranges of), File_Range*&: found (receives an array the caller must
+*              delete[], nullptr if there are none), unsigned int&: found_generation (receives the generation after the refresh).
+* Output:      unsigned int: number of ranges.
+*/
+unsigned int Data_Catalog::refresh(std::string country_name, File_Range*& found, unsigned int& found_generation){
+    std::lock_guard<std::mutex> guard(catalog_lock);
+    found = nullptr;
+
+    // Ranges that start at or after these offsets are new. Files that weren't indexed yet are still at 0.
+    std::uint64_t* old_sizes = new std::uint64_t[num_files + 1];
+    for (unsigned int i = 0; i < num_files; i++){
+        old_sizes[i] = indexed_sizes[i];
+    }
+    indexFiles();
+
+    bool rewritten = false;
+    bool grown = false;
+    for (unsigned int i = 0; i < num_files; i++){
+        std::ifstream file(files[i], std::ios::in | std::ios::binary | std::ios::ate);
+        std::uint64_t size = file.is_open() ? static_cast<std::uint64_t>(file.tellg()) : 0;
+        if (size < indexed_sizes[i] || readTail(files[i], indexed_sizes[i]) != tails[i]){
+            rewritten = true;
+        } else if (size > indexed_sizes[i]){
+            grown = true;
+        }
+    }
+
+    if (rewritten){
+        for (unsigned int i = 0; i < num_files; i++){
+            indexed_sizes[i] = 0;
+            old_sizes[i] = 0;
+        }
+        num_ranges = 0;
+        scanFiles(0, false);
+        generation++;
+    } else if (grown){
+        scanFiles(0, false);
+        generation++;
+    }
+    found_generation = generation;
+
+    std::uint32_t country_id = String_Table::global().find(country_name);
+    unsigned int count = 0;
+    if (country_id != String_Table::NOT_FOUND){
+        Row_Range key = {country_id, 0, 0, 0};
+        Row_Range* first = std::lower_bound(ranges, ranges + num_ranges, key, [](const Row_Range& a, const Row_Range& b){
+            return a.country_id < b.country_id;
+        });
+        Row_Range* last = first;
+        while (last < ranges + num_ranges && last->country_id == country_id){
+            last++;
+        }
+
+        found = (last > first) ? new File_Range[last - first] : nullptr;
+        for (Row_Range* range = first; range < last; range++){
+            if (range->begin >= old_sizes[range->file_idx]){
+                found[count].file_name = files[range->file_idx];
+                found[count].begin = range->begin;
+                found[count].end = range->end;
+                count++;
+            }
+        }
+    }
+    delete[] old_sizes;
+    return count;
+}
+
+/*
+* Description: Returns the last bytes (up to TAIL_SIZE) before an offset of a file, which refresh compares to tell
+*              appended files from rewritten ones.
+* Input:       std::string: file_name, uint64_t: size (offset the tail ends at).
+*/
+std::string Data_Catalog::readTail(std::string file_name, std::uint64_t size){
+    const std::uint64_t TAIL_SIZE = 64;
+    std::uint64_t length = (size < TAIL_SIZE) ? size : TAIL_SIZE;
+
+    std::ifstream file(file_name, std::ios::in | std::ios::binary);
+    std::string tail(length, '\0');
+    file.seekg(size - length);
+    file.read(&tail[0], length);
+    tail.resize(file.gcount());
+    return tail;
+}
+
+/*
+* Description: Scans a data file from an offset, and returns the ranges of consecutive rows that share a country name.
+*              A country whose rows are split up by other countries gets one range per run.
+* Input:       std::string: file_name, uint32_t: file_idx (stored in the ranges), uint64_t: offset (byte to start at,
+*              must be the start of a row), bool: include_partial (see scanFiles), Row_Range*& / size_t& / unsigned int&:
+*              found array, its capacity and size, uint64_t&: file_size (receives the offset just past the last indexed row).
+*/
+void Data_Catalog::scanFile(std::string file_name, std::uint32_t file_idx, std::uint64_t offset, bool include_partial,
+                            Row_Range*& found, std::size_t& found_size, unsigned int& num_found, std::uint64_t& file_size){
+    std::ifstream file(file_name, std::ios::in | std::ios::binary);
+    file.seekg(offset);
+
+    std::string line;
+    std::string current = "";
+    Row_Range range = {0, file_idx, offset, offset};
+    std::uint64_t position = offset;
+
+    while (std::getline(file, line)){
+        // Row without a line break at the end of the file may be cut off, it is indexed once it is complete.
+        if (file.eof() && !include_partial){
+            break;
+        }
+        std::uint64_t row_end = position + line.size() + (file.eof() ? 0 : 1);
+
+        // Blank lines end the current run, they belong to no country.
+        if (line.empty() || line == "\r"){
+            if (range.begin != range.end){
+                addRange(found, found_size, num_found, range);
+            }
+            current = "";
+            range.begin = row_end;
+            range.end = row_end;
+            position = row_end;
+            continue;
+        }
+        std::string name = line.substr(0, line.find(','));
+
+        if (name != current || range.begin == range.end){
+            if (range.begin != range.end){
+                addRange(found, found_size, num_found, range);
+            }
+            current = name;
+            range.country_id = String_Table::global().intern(name);
+            range.begin = position;
+        }
+        range.end = row_end;
+        position = row_end;
+    }
+
+    if (range.begin != range.end){
+        addRange(found, found_size, num_found, range);
+    }
+    file_size = position;
+}
+
+/*
+* Description: Appends a range to a range array, doubling its capacity when it is full.
+*/
+void Data_Catalog::addRange(Row_Range*& target, std::size_t& target_size, unsigned int& count, Row_Range range){
+    if (count >= target_size){
+        std::size_t new_size = (target_size == 0) ? 16 : target_size * 2;
+        Row_Range* temp = new Row_Range[new_size];
+        for (unsigned int i = 0; i < count; i++){
+            temp[i] = target[i];
+        }
+        delete[] target;
+        target = temp;
+        target_size = new_size;
+    }
+    target[count] = range;
+    count++;
+}
+
+Data_Catalog::~Data_Catalog(){
+    delete[] files;
+    delete[] indexed_sizes;
+    delete[] tails;
+    delete[] ranges;
+}
@@ -0,0 +1,69 @@
+#ifndef DATA_CATALOG_H
+#define DATA_CATALOG_H
+
+#include <string>
+#include <cstdint>
+#include <mutex>
+
+// Run of consecutive rows of one country in one data file, as byte offsets [begin, end).
+struct Row_Range {
+    std::uint32_t country_id;
+    std::uint32_t file_idx;
+    std::uint64_t begin;
+    std::uint64_t end;
+};
+
+// Row_Range handed out to readers, with the file name copied so it stays valid if files are added or dropped meanwhile.
+struct File_Range {
+    std::string file_name;
+    std::uint64_t begin;
+    std::uint64_t end;
+};
+
+class Data_Catalog {
+private:
+    int MIN_ARRAY_SIZE;
+
+    // Registered data files, how many bytes of each were indexed, and the last bytes before that offset.
+    std::string* files;
+    std::uint64_t* indexed_sizes;
+    std::string* tails;
+    std::size_t files_size;
+    unsigned int num_files;
+    unsigned int indexed_files;
+
+    // Row ranges of every indexed file, sorted by country id then file then offset, so the rows of one country
+    // are one contiguous run in file order.
+    Row_Range* ranges;
+    std::size_t ranges_size;
+    unsigned int num_ranges;
+
+    // Changes every time the set of files (or their contents) changes, so readers can tell their copy of a country is stale.
+    unsigned int generation;
+
+    // Countries are read on the prefetch thread too, so every public method is serialized.
+    std::mutex catalog_lock;
+
+    void indexFiles();
+    void scanFiles(unsigned int first_file, bool include_partial);
+    static void scanFile(std::string file_name, std::uint32_t file_idx, std::uint64_t offset, bool include_partial,
+                         Row_Range*& found, std::size_t& found_size, unsigned int& num_found, std::uint64_t& file_size);
+    static std::string readTail(std::string file_name, std::uint64_t size);
+    static void addRange(Row_Range*& target, std::size_t& target_size, unsigned int& count, Row_Range range);
+
+public:
+    Data_Catalog();
+    ~Data_Catalog();
+
+    static Data_Catalog& shared();
+
+    bool addFile(std::string file_name);
+    bool dropFile(std::string file_name);
+    void listFiles();
+    unsigned int findRanges(std::string country_name, File_Range*& found, unsigned int& found_generation);
+    unsigned int refresh(std::string country_name, File_Range*& found, unsigned int& found_generation);
+    unsigned int copyFileNames(std::string*& names);
+    unsigned int getGeneration();
+};
+
+#endif
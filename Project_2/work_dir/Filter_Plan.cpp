@@ -0,0 +1,353 @@
+#include <string>
+#include <sstream>
+#include <limits>
+#include <climits>
+#include "Filter_Plan.hpp"
+#include "Task_Pool.hpp"
+
+Filter_Plan::Filter_Plan()
+    : MIN_ARRAY_SIZE(2),
+      SCAN_GRAIN(64),
+      STATS_FIELDS(7),
+      ranges(nullptr),
+      ranges_size(0),
+      num_ranges(0),
+      clauses(nullptr),
+      clauses_size(0),
+      num_clauses(0)
+{}
+
+Filter_Plan::~Filter_Plan(){
+    release();
+}
+
+/*
+* Description: Frees the compiled plan.
+*/
+void Filter_Plan::release(){
+    delete[] ranges;
+    delete[] clauses;
+    ranges = nullptr;
+    clauses = nullptr;
+    ranges_size = 0;
+    clauses_size = 0;
+    num_ranges = 0;
+    num_clauses = 0;
+}
+
+/*
+* Description: Compiles a query (see Filter_Plan.hpp) into clauses, with each distinct year range stored once.
+* Input:       std::istringstream&: query (rest of the FILTER line).
+* Output:      bool: true if the query is valid, false if it is empty or any clause can't be parsed.
+*/
+bool Filter_Plan::compile(std::istringstream& query){
+    release();
+
+    std::string metric_token;
+    std::string comparison_token;
+    std::string value_token;
+    std::string joiner;
+    while (query >> metric_token){
+        if (!(query >> comparison_token >> value_token) || !parseClause(metric_token, comparison_token, value_token)){
+            release();
+            return false;
+        }
+
+        // Clauses are joined by AND, a query can't end with one.
+        if (!(query >> joiner)){
+            return true;
+        }
+        if (joiner != "AND"){
+            release();
+            return false;
+        }
+    }
+
+    // Empty query, or AND at the end.
+    release();
+    return false;
+}
+
+/*
+* Description: Parses one clause and adds it to the plan.
+* Input:       std::string: metric_token (e.g. MEAN, MAX@1990:2000, VALUE@2000), std::string: comparison_token (e.g. >=),
+*              std::string: value_token (threshold).
+* Output:      bool: true if the clause is valid.
+*/
+bool Filter_Plan::parseClause(std::string metric_token, std::string comparison_token, std::string value_token){
+    Clause clause;
+
+    // Splits the metric name from its year range.
+    std::size_t at = metric_token.find('@');
+    std::string name = metric_token.substr(0, at);
+    int first_year = INT_MIN;
+    int last_year = INT_MAX;
+    if (at != std::string::npos){
+        std::string years = metric_token.substr(at + 1);
+        std::size_t colon = years.find(':');
+        if (!parseYear(years.substr(0, colon), first_year)){
+            return false;
+        }
+        last_year = first_year;
+        if (colon != std::string::npos && !parseYear(years.substr(colon + 1), last_year)){
+            return false;
+        }
+        if (first_year > last_year){
+            return false;
+        }
+    }
+
+    if (name == "MEAN"){
+        clause.metric = METRIC_MEAN;
+    } else if (name == "MIN"){
+        clause.metric = METRIC_MIN;
+    } else if (name == "MAX"){
+        clause.metric = METRIC_MAX;
+    } else if (name == "SLOPE"){
+        clause.metric = METRIC_SLOPE;
+    } else if (name == "COUNT"){
+        clause.metric = METRIC_COUNT;
+    } else if (name == "VALUE"){
+        // Value of a single year is the mean of the range holding only that year (undefined if the year is missing).
+        if (at == std::string::npos || first_year != last_year){
+            return false;
+        }
+        clause.metric = METRIC_MEAN;
+    } else {
+        return false;
+    }
+
+    if (comparison_token == "<"){
+        clause.comparison = COMPARE_LT;
+    } else if (comparison_token == "<="){
+        clause.comparison = COMPARE_LE;
+    } else if (comparison_token == ">"){
+        clause.comparison = COMPARE_GT;
+    } else if (comparison_token == ">="){
+        clause.comparison = COMPARE_GE;
+    } else if (comparison_token == "=="){
+        clause.comparison = COMPARE_EQ;
+    } else if (comparison_token == "!="){
+        clause.comparison = COMPARE_NE;
+    } else {
+        return false;
+    }
+
+    std::size_t parsed = 0;
+    try {
+        clause.threshold = std::stod(value_token, &parsed);
+    } catch (...){
+        return false;
+    }
+    if (parsed != value_token.size() || clause.threshold != clause.threshold){
+        return false;
+    }
+
+    clause.range_idx = addRange(first_year, last_year);
+    addClause(clause);
+    return true;
+}
+
+/*
+* Description: Parses a year of a metric's range.
+* Input:       std::string: token (digits only), int&: year (set to the year).
+* Output:      bool: true if token is a year.
+*/
+bool Filter_Plan::parseYear(std::string token, int& year){
+    if (token.empty() || token.size() > 9 || token.find_first_not_of("0123456789") != std::string::npos){
+        return false;
+    }
+    year = std::stoi(token);
+    return true;
+}
+
+/*
+* Description: Returns the index of a year range in the plan, adding it if no earlier clause used it.
+* Input:       int: first_year, int: last_year.
+* Output:      unsigned int: index of the range.
+*/
+unsigned int Filter_Plan::addRange(int first_year, int last_year){
+    for (unsigned int i = 0; i < num_ranges; i++){
+        if (ranges[i].first_year == first_year && ranges[i].last_year == last_year){
+            return i;
+        }
+    }
+
+    if (num_ranges == ranges_size){
+        std::size_t new_size = (ranges_size == 0) ? MIN_ARRAY_SIZE : ranges_size * 2;
+        Year_Range* grown = new Year_Range[new_size];
+        for (unsigned int i = 0; i < num_ranges; i++){
+            grown[i] = ranges[i];
+        }
+        delete[] ranges;
+        ranges = grown;
+        ranges_size = new_size;
+    }
+    ranges[num_ranges] = {first_year, last_year};
+    num_ranges++;
+    return num_ranges - 1;
+}
+
+/*
+* Description: Appends a clause to the plan.
+*/
+void Filter_Plan::addClause(Clause clause){
+    if (num_clauses == clauses_size){
+        std::size_t new_size = (clauses_size == 0) ? MIN_ARRAY_SIZE : clauses_size * 2;
+        Clause* grown = new Clause[new_size];
+        for (unsigned int i = 0; i < num_clauses; i++){
+            grown[i] = clauses[i];
+        }
+        delete[] clauses;
+        clauses = grown;
+        clauses_size = new_size;
+    }
+    clauses[num_clauses] = clause;
+    num_clauses++;
+}
+
+/*
+* Description: Evaluates the plan over every series. First pass (on the task pool) computes the stats of each series over
+*              each distinct range, stored as one column per field. Then every clause turns one range's columns into a column
+*              of metric values and compares the whole column against its threshold, clearing the matches that fail. Those
+*              passes are branch-free loops over contiguous arrays, which GCC vectorizes at -O3. The all target builds without -O,
+*              so there they run scalar.
+* Input:       Time_Series*: series (array of series), unsigned int: count (number of series),
+*              unsigned char*: matches (at least count elements, matches[i] is set to 1 if series i satisfies every clause, else 0).
+* Output:      unsigned int: number of matching series.
+*/
+unsigned int Filter_Plan::evaluate(Time_Series* series, unsigned int count, unsigned char* matches){
+    // One block for every column: range r has fields [r * STATS_FIELDS, (r + 1) * STATS_FIELDS) of count elements each.
+    std::size_t length = count;
+    double* block = new double[num_ranges * STATS_FIELDS * length + 1];
+    Stats_Columns* columns = new Stats_Columns[num_ranges + 1];
+    for (unsigned int r = 0; r < num_ranges; r++){
+        double* base = block + r * STATS_FIELDS * length;
+        columns[r] = {base, base + length, base + 2 * length, base + 3 * length, base + 4 * length, base + 5 * length, base + 6 * length};
+    }
+
+    Year_Range* plan_ranges = ranges;
+    unsigned int range_count = num_ranges;
+    Task_Pool::shared().parallelFor(count, SCAN_GRAIN, [series, columns, plan_ranges, range_count](std::size_t begin, std::size_t end){
+        for (unsigned int r = 0; r < range_count; r++){
+            for (std::size_t i = begin; i < end; i++){
+                Series_Stats stats = series[i].rangeStats(plan_ranges[r].first_year, plan_ranges[r].last_year);
+                columns[r].count[i] = stats.count;
+                columns[r].sum[i] = stats.sum;
+                columns[r].min[i] = stats.min;
+                columns[r].max[i] = stats.max;
+                columns[r].sum_x[i] = stats.sum_x;
+                columns[r].sum_xx[i] = stats.sum_xx;
+                columns[r].sum_xy[i] = stats.sum_xy;
+            }
+        }
+    });
+
+    unsigned char initial = (num_clauses > 0) ? 1 : 0;
+    for (unsigned int i = 0; i < count; i++){
+        matches[i] = initial;
+    }
+
+    double* values = new double[count + 1];
+    for (unsigned int c = 0; c < num_clauses; c++){
+        metricColumn(clauses[c].metric, columns[clauses[c].range_idx], count, values);
+        applyComparison(clauses[c].comparison, clauses[c].threshold, values, count, matches);
+    }
+
+    unsigned int num_matches = 0;
+    for (unsigned int i = 0; i < count; i++){
+        num_matches += matches[i];
+    }
+
+    delete[] values;
+    delete[] columns;
+    delete[] block;
+    return num_matches;
+}
+
+/*
+* Description: Computes a metric for every series of a range. Undefined values are set to NaN, which fails every comparison.
+*              Operands are loaded before the select so each loop has no control flow.
+* Input:       Metric: metric, const Stats_Columns&: columns (stats of the range), unsigned int: count, double*: out (count elements).
+*/
+void Filter_Plan::metricColumn(Metric metric, const Stats_Columns& columns, unsigned int count, double* out){
+    double nan = std::numeric_limits<double>::quiet_NaN();
+    switch (metric){
+    case METRIC_MEAN:
+        // 0 / 0 is already NaN for a range without valid data.
+        for (unsigned int i = 0; i < count; i++){
+            out[i] = columns.sum[i] / columns.count[i];
+        }
+        break;
+    case METRIC_MIN:
+        for (unsigned int i = 0; i < count; i++){
+            double n = columns.count[i];
+            double min = columns.min[i];
+            out[i] = (n > 0) ? min : nan;
+        }
+        break;
+    case METRIC_MAX:
+        for (unsigned int i = 0; i < count; i++){
+            double n = columns.count[i];
+            double max = columns.max[i];
+            out[i] = (n > 0) ? max : nan;
+        }
+        break;
+    case METRIC_SLOPE:
+        // Least squares slope, same line as fitLine. Fewer than two points leave the denominator at 0.
+        for (unsigned int i = 0; i < count; i++){
+            double n = columns.count[i];
+            double sum_x = columns.sum_x[i];
+            double numerator = n * columns.sum_xy[i] - sum_x * columns.sum[i];
+            double denominator = n * columns.sum_xx[i] - sum_x * sum_x;
+            out[i] = numerator / ((denominator != 0) ? denominator : nan);
+        }
+        break;
+    case METRIC_COUNT:
+        for (unsigned int i = 0; i < count; i++){
+            out[i] = columns.count[i];
+        }
+        break;
+    }
+}
+
+/*
+* Description: Compares a column of values against a threshold, clearing matches[i] where the comparison is false.
+* Input:       Comparison: comparison, double: threshold, double*: values (count elements), unsigned int: count,
+*              unsigned char*: matches (count elements).
+*/
+void Filter_Plan::applyComparison(Comparison comparison, double threshold, double* values, unsigned int count, unsigned char* matches){
+    switch (comparison){
+    case COMPARE_LT:
+        for (unsigned int i = 0; i < count; i++){
+            matches[i] = (values[i] < threshold) ? matches[i] : 0;
+        }
+        break;
+    case COMPARE_LE:
+        for (unsigned int i = 0; i < count; i++){
+            matches[i] = (values[i] <= threshold) ? matches[i] : 0;
+        }
+        break;
+    case COMPARE_GT:
+        for (unsigned int i = 0; i < count; i++){
+            matches[i] = (values[i] > threshold) ? matches[i] : 0;
+        }
+        break;
+    case COMPARE_GE:
+        for (unsigned int i = 0; i < count; i++){
+            matches[i] = (values[i] >= threshold) ? matches[i] : 0;
+        }
+        break;
+    case COMPARE_EQ:
+        for (unsigned int i = 0; i < count; i++){
+            matches[i] = (values[i] == threshold) ? matches[i] : 0;
+        }
+        break;
+    case COMPARE_NE:
+        // NaN != threshold is true, so undefined values are excluded explicitly.
+        for (unsigned int i = 0; i < count; i++){
+            matches[i] = ((values[i] != threshold) & (values[i] == values[i])) ? matches[i] : 0;
+        }
+        break;
+    }
+}
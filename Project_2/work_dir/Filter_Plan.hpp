@@ -0,0 +1,73 @@
+#ifndef FILTER_PLAN_H
+#define FILTER_PLAN_H
+
+#include <string>
+#include <sstream>
+#include <cstddef>
+#include "Time_Series.hpp"
+
+// Predicate of a FILTER command, compiled once and then evaluated over every series of a country.
+// A query is clauses joined by AND, each "<metric> <op> <number>":
+//     metric:  MEAN, MIN, MAX, SLOPE or COUNT, over every year or only years in [Y1, Y2] with @Y1:Y2 (or @Y for a single year),
+//              or VALUE@Y, the value in year Y.
+//     op:      <, <=, >, >=, == or !=.
+// e.g. "MEAN > 5 AND MAX@1990:2000 > 10 AND SLOPE > 0". A metric that is undefined for a series (no valid data in its
+// range, or fewer than two points for SLOPE) makes the clause false.
+class Filter_Plan {
+private:
+    enum Metric { METRIC_MEAN, METRIC_MIN, METRIC_MAX, METRIC_SLOPE, METRIC_COUNT };
+    enum Comparison { COMPARE_LT, COMPARE_LE, COMPARE_GT, COMPARE_GE, COMPARE_EQ, COMPARE_NE };
+
+    struct Year_Range {
+        int first_year;
+        int last_year;
+    };
+
+    struct Clause {
+        Metric metric;
+        unsigned int range_idx;
+        Comparison comparison;
+        double threshold;
+    };
+
+    // Series_Stats of every series over one range, one array per field (element i belongs to series i).
+    struct Stats_Columns {
+        double* count;
+        double* sum;
+        double* min;
+        double* max;
+        double* sum_x;
+        double* sum_xx;
+        double* sum_xy;
+    };
+
+    int MIN_ARRAY_SIZE;
+    std::size_t SCAN_GRAIN;
+    std::size_t STATS_FIELDS;
+
+    // Distinct year ranges of the query. Stats are computed once per series and range, and shared by every clause on that range.
+    Year_Range* ranges;
+    std::size_t ranges_size;
+    unsigned int num_ranges;
+
+    Clause* clauses;
+    std::size_t clauses_size;
+    unsigned int num_clauses;
+
+    void release();
+    bool parseClause(std::string metric_token, std::string comparison_token, std::string value_token);
+    unsigned int addRange(int first_year, int last_year);
+    void addClause(Clause clause);
+    static bool parseYear(std::string token, int& year);
+    static void metricColumn(Metric metric, const Stats_Columns& columns, unsigned int count, double* out);
+    static void applyComparison(Comparison comparison, double threshold, double* values, unsigned int count, unsigned char* matches);
+
+public:
+    Filter_Plan();
+    ~Filter_Plan();
+
+    bool compile(std::istringstream& query);
+    unsigned int evaluate(Time_Series* series, unsigned int count, unsigned char* matches);
+};
+
+#endif
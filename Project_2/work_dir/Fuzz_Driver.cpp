@@ -0,0 +1,321 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <sstream>
+#include <vector>
+#include <random>
+#include <cstdio>
+#include <cstdlib>
+
+/*
+* Differential fuzzer: generates random command scripts, runs them through the program under test (engine)
+* and the unmodified reference implementation (oracle), and reports the first line where their outputs differ.
+*
+* Usage:       ./fuzz.out [engine] [oracle] [runs] [seed] [commands]
+*              defaults:  ./a.out   ./reference.out 100 1 200
+*
+* Every command of the reference program prints exactly one line, so output line i belongs to command i.
+* Commands the oracle doesn't have are translated into the equivalent sequence of reference commands (see emit).
+*/
+
+struct Fuzz_Script {
+    std::vector<std::string> engine_commands;
+    std::vector<std::string> oracle_commands;
+    // Engine command that produced each expected output line.
+    std::vector<std::size_t> line_owner;
+};
+
+struct Fuzz_Vocabulary {
+    std::vector<std::string> countries;
+    std::vector<std::string> codes;
+};
+
+/*
+* Description: Reads the country names and series codes that appear in the data file, so generated commands mostly hit real series.
+* Input:       std::string: file_name (data file), Fuzz_Vocabulary&: vocabulary (filled with distinct names/codes).
+* Output:      bool: false if the file could not be read.
+*/
+bool readVocabulary(std::string file_name, Fuzz_Vocabulary& vocabulary){
+    std::ifstream file(file_name);
+    if (!file.is_open()){
+        return false;
+    }
+
+    std::string line;
+    std::string country;
+    std::string field;
+    while (std::getline(file, line)){
+        std::istringstream iss(line);
+        std::getline(iss, country, ',');
+        std::getline(iss, field, ',');      // country code
+        std::getline(iss, field, ',');      // series name
+        std::getline(iss, field, ',');      // series code
+
+        if (vocabulary.countries.empty() || vocabulary.countries.back() != country){
+            vocabulary.countries.push_back(country);
+        }
+        bool known = false;
+        for (std::size_t i = 0; i < vocabulary.codes.size() && !known; i++){
+            known = (vocabulary.codes[i] == field);
+        }
+        if (!known){
+            vocabulary.codes.push_back(field);
+        }
+    }
+
+    // Names that are not in the file exercise the failure paths.
+    vocabulary.countries.push_back("Atlantis");
+    vocabulary.codes.push_back("NOT.A.CODE");
+    return true;
+}
+
+/*
+* Description: Adds one command to the script. oracle_commands is what the reference program runs instead of engine_command,
+*              and num_lines is how many output lines the command prints.
+*/
+void emit(Fuzz_Script& script, std::string engine_command, std::vector<std::string> oracle_commands, std::size_t num_lines){
+    std::size_t owner = script.engine_commands.size();
+    script.engine_commands.push_back(engine_command);
+    for (std::size_t i = 0; i < oracle_commands.size(); i++){
+        script.oracle_commands.push_back(oracle_commands[i]);
+    }
+    for (std::size_t i = 0; i < num_lines; i++){
+        script.line_owner.push_back(owner);
+    }
+}
+
+/*
+* Description: Adds a command both programs understand, which prints one line.
+*/
+void emit(Fuzz_Script& script, std::string command){
+    emit(script, command, std::vector<std::string>(1, command), 1);
+}
+
+/*
+* Description: Picks a year of the csv range (1960 to 2023), which every loaded series starts out with.
+*/
+int randomYear(std::mt19937& rng){
+    std::uniform_int_distribution<int> inside(1960, 2023);
+    return inside(rng);
+}
+
+/*
+* Description: Returns whether a year may be missing from a series, because a negative update removed it.
+*              The reference is the unmodified original code: its insertSeriesElement never stores the new element and writes
+*              one slot past the arrays, and its returnYearIdx reads years[0] of an emptied series. Commands that could reach
+*              those paths (adding or updating a year the series doesn't have) are not generated, since the oracle's output is
+*              undefined there. Loading another country doesn't clear removed, which only makes the check more conservative.
+* Input:       std::vector<std::string>&: removed ("<code> <year>" of every year removed so far), std::string: code, int: year.
+*/
+bool mayBeMissing(std::vector<std::string>& removed, std::string code, int year){
+    std::string key = code + " " + std::to_string(year);
+    for (std::size_t i = 0; i < removed.size(); i++){
+        if (removed[i] == key){
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+* Description: Picks a year the series still has, -1 if a few tries only found removed years.
+*/
+int presentYear(std::mt19937& rng, std::vector<std::string>& removed, std::string code){
+    for (int attempt = 0; attempt < 8; attempt++){
+        int year = randomYear(rng);
+        if (!mayBeMissing(removed, code, year)){
+            return year;
+        }
+    }
+    return -1;
+}
+
+/*
+* Description: Picks a datum: usually a positive value, sometimes the missing data indicator, a negative value (removal) or zero.
+*/
+std::string randomDatum(std::mt19937& rng){
+    std::uniform_int_distribution<int> pick(0, 9);
+    int kind = pick(rng);
+    if (kind == 0){
+        return "-1";
+    } else if (kind == 1){
+        return "-5";
+    } else if (kind == 2){
+        return "0";
+    }
+    std::uniform_int_distribution<int> value(1, 100000);
+    std::ostringstream oss;
+    oss << value(rng) / 100.0;
+    return oss.str();
+}
+
+/*
+* Description: Generates a random script of num_commands commands, always starting with a LOAD_P2 and ending with EXIT.
+*/
+Fuzz_Script generateScript(std::mt19937& rng, Fuzz_Vocabulary& vocabulary, std::size_t num_commands){
+    Fuzz_Script script;
+    std::uniform_int_distribution<std::size_t> pick_country(0, vocabulary.countries.size() - 1);
+    std::uniform_int_distribution<std::size_t> pick_code(0, vocabulary.codes.size() - 1);
+    std::uniform_int_distribution<int> pick_command(0, 99);
+
+    // Series changed by a bulk command since the last LOAD_P2. Bulk merges pick capacity once instead of after every element,
+    // so TS_P2 of these series is expected to differ from the reference and is not generated.
+    std::vector<std::string> bulk_touched;
+
+    // Years removed from a series by a negative update (see mayBeMissing).
+    std::vector<std::string> removed;
+
+    emit(script, "LOAD_P2 " + vocabulary.countries[pick_country(rng) % (vocabulary.countries.size() - 1)]);
+
+    for (std::size_t i = 1; i < num_commands; i++){
+        int roll = pick_command(rng);
+        std::string code = vocabulary.codes[pick_code(rng)];
+
+        bool touched = false;
+        for (std::size_t t = 0; t < bulk_touched.size() && !touched; t++){
+            touched = (bulk_touched[t] == code);
+        }
+
+        if (roll < 3){
+            emit(script, "LOAD_P2 " + vocabulary.countries[pick_country(rng)]);
+            bulk_touched.clear();
+        } else if (roll < 13){
+            // BULK_ADD/BULK_UPDATE become one ADD_P2/UPDATE_P2 per pair for the oracle. Years are drawn from a small range so batches repeat years.
+            bool is_update = (pick_command(rng) % 2 == 0);
+            std::uniform_int_distribution<int> pick_size(0, 8);
+            std::uniform_int_distribution<int> pick_year(1995, 2005);
+            int size = pick_size(rng);
+
+            std::string engine_command = (is_update ? "BULK_UPDATE " : "BULK_ADD ") + code;
+            std::vector<std::string> oracle_commands;
+            std::vector<std::string> removed_by_batch;
+            for (int p = 0; p < size; p++){
+                int year = (pick_size(rng) == 0) ? randomYear(rng) : pick_year(rng);
+                if (mayBeMissing(removed, code, year)){
+                    continue;
+                }
+                std::string datum = randomDatum(rng);
+                std::string pair = std::to_string(year) + " " + datum;
+                engine_command += " " + pair;
+                oracle_commands.push_back((is_update ? "UPDATE_P2 " : "ADD_P2 ") + code + " " + pair);
+                if (is_update && datum[0] == '-'){
+                    removed_by_batch.push_back(code + " " + std::to_string(year));
+                }
+            }
+            // Years removed by the batch are only skipped from the next command on, same as for UPDATE_P2.
+            removed.insert(removed.end(), removed_by_batch.begin(), removed_by_batch.end());
+            emit(script, engine_command, oracle_commands, oracle_commands.size());
+            bulk_touched.push_back(code);
+        } else if (roll < 45){
+            int year = presentYear(rng, removed, code);
+            if (year < 0){
+                emit(script, "PRINT_P2 " + code);
+                continue;
+            }
+            std::string datum = randomDatum(rng);
+            if (roll < 25){
+                emit(script, "ADD_P2 " + code + " " + std::to_string(year) + " " + datum);
+            } else {
+                emit(script, "UPDATE_P2 " + code + " " + std::to_string(year) + " " + datum);
+                if (datum[0] == '-'){
+                    removed.push_back(code + " " + std::to_string(year));
+                }
+            }
+        } else if (roll < 60){
+            emit(script, "PRINT_P2 " + code);
+        } else if (roll < 70){
+            emit(script, (touched ? "PRINT_P2 " : "TS_P2 ") + code);
+        } else if (roll < 78){
+            emit(script, "BIGGEST_P2");
+        } else if (roll < 84){
+            emit(script, "LIST_P2");
+        } else if (roll < 90){
+            emit(script, "DELETE_P2 " + code);
+        } else {
+            emit(script, "PRINT_P2 " + code);
+        }
+    }
+
+    script.engine_commands.push_back("EXIT");
+    script.oracle_commands.push_back("EXIT");
+    return script;
+}
+
+/*
+* Description: Writes commands to a file, one per line.
+*/
+void writeScript(std::string file_name, std::vector<std::string>& commands){
+    std::ofstream file(file_name);
+    for (std::size_t i = 0; i < commands.size(); i++){
+        file << commands[i] << "\n";
+    }
+}
+
+/*
+* Description: Runs program with the given input file, and returns its output split into lines.
+*/
+std::vector<std::string> runProgram(std::string program, std::string input_file, std::string output_file){
+    std::string command = program + " < " + input_file + " > " + output_file + " 2>/dev/null";
+    std::system(command.c_str());
+
+    std::vector<std::string> lines;
+    std::ifstream file(output_file);
+    std::string line;
+    while (std::getline(file, line)){
+        // Trailing spaces are not significant (PRINT_P2 ends every pair with a space).
+        while (!line.empty() && line.back() == ' '){
+            line.pop_back();
+        }
+        lines.push_back(line);
+    }
+    return lines;
+}
+
+int main(int argc, char* argv[]){
+    std::string engine = (argc > 1) ? argv[1] : "./a.out";
+    std::string oracle = (argc > 2) ? argv[2] : "./reference.out";
+    unsigned long runs = (argc > 3) ? std::stoul(argv[3]) : 100;
+    unsigned long seed = (argc > 4) ? std::stoul(argv[4]) : 1;
+    std::size_t num_commands = (argc > 5) ? std::stoul(argv[5]) : 200;
+
+    Fuzz_Vocabulary vocabulary;
+    if (!readVocabulary("lab2_multidata.csv", vocabulary)){
+        std::cout << "cannot read lab2_multidata.csv" << std::endl;
+        return 2;
+    }
+
+    for (unsigned long run = 0; run < runs; run++){
+        std::mt19937 rng(seed + run);
+        Fuzz_Script script = generateScript(rng, vocabulary, num_commands);
+
+        writeScript("fuzz_engine.in", script.engine_commands);
+        writeScript("fuzz_oracle.in", script.oracle_commands);
+        std::vector<std::string> engine_lines = runProgram(engine, "fuzz_engine.in", "fuzz_engine.out");
+        std::vector<std::string> oracle_lines = runProgram(oracle, "fuzz_oracle.in", "fuzz_oracle.out");
+
+        // Finds first line that differs, or is missing from one of the outputs.
+        std::size_t num_lines = script.line_owner.size();
+        for (std::size_t i = 0; i < num_lines; i++){
+            std::string engine_line = (i < engine_lines.size()) ? engine_lines[i] : "<no output>";
+            std::string oracle_line = (i < oracle_lines.size()) ? oracle_lines[i] : "<no output>";
+            if (engine_line == oracle_line){
+                continue;
+            }
+
+            std::size_t owner = script.line_owner[i];
+            std::cout << "divergence in run " << run << " (seed " << seed + run << "), command " << owner + 1
+                      << ": " << script.engine_commands[owner] << std::endl;
+            std::cout << "  engine: " << engine_line << std::endl;
+            std::cout << "  oracle: " << oracle_line << std::endl;
+            std::cout << "scripts kept in fuzz_engine.in / fuzz_oracle.in" << std::endl;
+            return 1;
+        }
+    }
+
+    std::remove("fuzz_engine.in");
+    std::remove("fuzz_oracle.in");
+    std::remove("fuzz_engine.out");
+    std::remove("fuzz_oracle.out");
+    std::cout << "no divergence in " << runs << " runs" << std::endl;
+    return 0;
+}
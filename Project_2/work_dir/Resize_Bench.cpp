@@ -0,0 +1,149 @@
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <chrono>
+#include "Time_Series.hpp"
+#include "Resize_Policy.hpp"
+
+/*
+* Benchmark of the resize policies on workloads that sit on a resize boundary.
+*
+* Usage:       ./bench.out [rounds]
+*              default:   ./bench.out 100000
+*
+* For every policy and workload, prints how many times the series was reallocated, its final capacity, and ns per operation.
+*/
+
+struct Bench_Result {
+    unsigned long reallocations;
+    std::size_t capacity;
+    double ns_per_op;
+};
+
+/*
+* Description: Loads a series with count consecutive years of data, starting at 1960.
+*/
+void fillSeries(Time_Series& series, unsigned int count){
+    std::ostringstream row;
+    row << "Bench series,BENCH";
+    for (unsigned int i = 0; i < count; i++){
+        row << "," << i + 1;
+    }
+    std::istringstream input(row.str());
+    series.load(input);
+}
+
+/*
+* Description: Adds the element for a year, counting the reallocation if the capacity changed.
+*/
+void addYear(Time_Series& series, int year, unsigned long& reallocations){
+    std::size_t before = series.getArraySize();
+    series.addSeriesElement(year, 1.0);
+    reallocations += (series.getArraySize() != before);
+}
+
+/*
+* Description: Removes the element of a year (what UPDATE_P2 with a negative value does).
+*/
+void removeYear(Time_Series& series, int year){
+    int idx = series.returnYearIdx(year);
+    if (idx >= 0){
+        series.removeSeriesElement(idx);
+    }
+}
+
+/*
+* Description: Runs one workload under a policy. ops is set to the number of add/remove operations it performed.
+*              Workloads:
+*                  grow:     series exactly full, then ADD/remove of one year alternate (growth boundary).
+*                  shrink:   series just above a quarter of its capacity, then remove/ADD alternate (shrink boundary).
+*                  sawtooth: series repeatedly grows from 64 to 1024 elements and is cut back to 64.
+*                  swing:    series repeatedly grows from 64 to 65 elements and is cut back to 31, crossing both the growth
+*                            boundary and the 1/4 shrink boundary, so the default policy reallocates twice per cycle.
+*              The default double/quarter rule doesn't oscillate on a single boundary (grow, shrink), only swing makes it.
+*/
+Bench_Result runWorkload(std::string workload, const Resize_Policy* policy, unsigned long rounds){
+    Time_Series series;
+    Bench_Result result = {0, 0, 0};
+    unsigned long ops = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    if (workload == "grow"){
+        fillSeries(series, 64);
+        series.setPolicy(policy);
+        for (unsigned long r = 0; r < rounds; r++){
+            addYear(series, 1960 + 64, result.reallocations);
+            removeYear(series, 1960 + 64);
+            ops += 2;
+        }
+    } else if (workload == "shrink"){
+        fillSeries(series, 64);
+        series.setPolicy(policy);
+        // Adds 1 year past 64 to double the capacity to 128, then trims down to 33 elements (just above 128 / 4).
+        addYear(series, 1960 + 64, result.reallocations);
+        for (int year = 1960 + 64; year >= 1960 + 33; year--){
+            removeYear(series, year);
+        }
+        for (unsigned long r = 0; r < rounds; r++){
+            removeYear(series, 1960 + 32);
+            addYear(series, 1960 + 32, result.reallocations);
+            ops += 2;
+        }
+    } else if (workload == "swing"){
+        fillSeries(series, 64);
+        series.setPolicy(policy);
+        unsigned long cycles = rounds / 64 + 1;
+        for (unsigned long c = 0; c < cycles; c++){
+            // 65 elements grow the capacity to 128, removals down to 31 (<= 128 / 4) shrink it on the next add.
+            addYear(series, 1960 + 64, result.reallocations);
+            ops++;
+            for (int year = 1960 + 64; year >= 1960 + 31; year--){
+                removeYear(series, year);
+                ops++;
+            }
+            for (int year = 1960 + 31; year < 1960 + 64; year++){
+                addYear(series, year, result.reallocations);
+                ops++;
+            }
+        }
+    } else {
+        fillSeries(series, 64);
+        series.setPolicy(policy);
+        unsigned long cycles = rounds / 1024 + 1;
+        for (unsigned long c = 0; c < cycles; c++){
+            for (int year = 1960 + 64; year < 1960 + 1024; year++){
+                addYear(series, year, result.reallocations);
+                ops++;
+            }
+            for (int year = 1960 + 1023; year >= 1960 + 64; year--){
+                removeYear(series, year);
+                ops++;
+            }
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    result.capacity = series.getArraySize();
+    result.ns_per_op = std::chrono::duration<double, std::nano>(end - start).count() / ops;
+    return result;
+}
+
+int main(int argc, char* argv[]){
+    unsigned long rounds = (argc > 1) ? std::stoul(argv[1]) : 100000;
+
+    std::string workloads[] = {"grow", "shrink", "sawtooth", "swing"};
+    std::string policies[] = {"default", "hysteresis", "lazy", "compact"};
+
+    std::cout << std::left << std::setw(10) << "workload" << std::setw(12) << "policy" << std::right
+              << std::setw(14) << "reallocations" << std::setw(10) << "capacity" << std::setw(10) << "ns/op" << std::endl;
+    for (std::string& workload : workloads){
+        for (std::string& name : policies){
+            Bench_Result result = runWorkload(workload, Resize_Policy::find(name), rounds);
+            std::cout << std::left << std::setw(10) << workload << std::setw(12) << name << std::right
+                      << std::setw(14) << result.reallocations << std::setw(10) << result.capacity
+                      << std::setw(10) << std::fixed << std::setprecision(1) << result.ns_per_op << std::endl;
+        }
+    }
+    return 0;
+}
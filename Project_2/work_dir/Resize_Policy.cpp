@@ -0,0 +1,115 @@
+#include <string>
+#include <cmath>
+#include "Resize_Policy.hpp"
+
+// Presets selectable with POLICY. standard is the doubling/quartering rule the arrays always used.
+static const Resize_Policy STANDARD_POLICY("default", 2.0, 4, 2, false);
+static const Resize_Policy HYSTERESIS_POLICY("hysteresis", 2.0, 8, 2, false);
+static const Resize_Policy LAZY_POLICY("lazy", 2.0, 4, 2, true);
+static const Resize_Policy COMPACT_POLICY("compact", 1.5, 3, 2, false);
+
+Resize_Policy::Resize_Policy(std::string policy_name, double growth, std::size_t divisor, std::size_t factor, bool lazy)
+    : name(policy_name),
+      growth_factor(growth),
+      shrink_divisor(divisor),
+      shrink_factor(factor),
+      lazy_shrink(lazy)
+{}
+
+/*
+* Description: Returns the default policy: double when full, halve at 1/4 occupancy on the next write.
+*/
+const Resize_Policy* Resize_Policy::standard(){
+    return &STANDARD_POLICY;
+}
+
+/*
+* Description: Returns the preset with a name.
+* Input:       std::string: policy_name (default, hysteresis, lazy or compact).
+* Output:      const Resize_Policy*: the preset, nullptr if there is none with that name.
+*/
+const Resize_Policy* Resize_Policy::find(std::string policy_name){
+    const Resize_Policy* presets[] = {&STANDARD_POLICY, &HYSTERESIS_POLICY, &LAZY_POLICY, &COMPACT_POLICY};
+    for (const Resize_Policy* preset : presets){
+        if (preset->name == policy_name){
+            return preset;
+        }
+    }
+    return nullptr;
+}
+
+/*
+* Description: Returns the name of the policy, as reported by TS_P2.
+*/
+const std::string& Resize_Policy::getName() const{
+    return name;
+}
+
+/*
+* Description: Returns whether arrays only shrink when compacted (see idleCapacity).
+*/
+bool Resize_Policy::isLazy() const{
+    return lazy_shrink;
+}
+
+/*
+* Description: Applies the policy once, the way a single capacity check before a write does.
+* Input:       size_t: size (elements stored), size_t: capacity (current capacity), size_t: min_capacity (smallest allowed capacity).
+* Output:      size_t: capacity the array should have, equal to capacity if no resize is needed.
+*/
+std::size_t Resize_Policy::nextCapacity(std::size_t size, std::size_t capacity, std::size_t min_capacity) const{
+    if (size >= capacity){
+        std::size_t grown = static_cast<std::size_t>(std::ceil(capacity * growth_factor));
+        if (grown <= capacity){
+            grown = capacity + 1;
+        }
+        return (grown < min_capacity) ? min_capacity : grown;
+    }
+
+    if (!lazy_shrink && shrink_divisor > 0 && size != 0 && size <= capacity / shrink_divisor){
+        std::size_t shrunk = capacity / shrink_factor;
+        return (shrunk < min_capacity) ? min_capacity : shrunk;
+    }
+    return capacity;
+}
+
+/*
+* Description: Picks the capacity for a batch of writes at once: grows until size fits, then shrinks while the policy would
+*              shrink on a write (same as the doubling/quartering loop bulk merges always used with the default policy).
+* Input:       size_t: size (elements after the batch), size_t: capacity (current capacity), size_t: min_capacity.
+* Output:      size_t: capacity for the final size.
+*/
+std::size_t Resize_Policy::batchCapacity(std::size_t size, std::size_t capacity, std::size_t min_capacity) const{
+    std::size_t target = (capacity > 0) ? capacity : min_capacity;
+    while (size > target){
+        std::size_t grown = static_cast<std::size_t>(std::ceil(target * growth_factor));
+        target = (grown <= target) ? target + 1 : grown;
+    }
+
+    while (!lazy_shrink && shrink_divisor > 0 && size != 0 && size <= target / shrink_divisor){
+        std::size_t shrunk = (target / shrink_factor < min_capacity) ? min_capacity : target / shrink_factor;
+        if (shrunk == target){
+            break;
+        }
+        target = shrunk;
+    }
+    return target;
+}
+
+/*
+* Description: Picks the capacity when an array is compacted while idle: shrinks for as long as the shrink rule holds,
+*              including for lazy policies, which skip shrinking on writes.
+* Input:       size_t: size (elements stored), size_t: capacity (current capacity), size_t: min_capacity.
+* Output:      size_t: compacted capacity.
+*/
+std::size_t Resize_Policy::idleCapacity(std::size_t size, std::size_t capacity, std::size_t min_capacity) const{
+    std::size_t target = capacity;
+    while (shrink_divisor > 0 && size != 0 && size <= target / shrink_divisor){
+        std::size_t shrunk = (target / shrink_factor < min_capacity) ? min_capacity : target / shrink_factor;
+        if (shrunk == target){
+            break;
+        }
+        target = shrunk;
+    }
+    return target;
+}
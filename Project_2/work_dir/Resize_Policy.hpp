@@ -0,0 +1,31 @@
+#ifndef RESIZE_POLICY_H
+#define RESIZE_POLICY_H
+
+#include <string>
+#include <cstddef>
+
+// How a dynamic array (series arrays, country series array) picks its capacity.
+// Arrays grow by growth_factor when full. They shrink by shrink_factor once size <= capacity / shrink_divisor,
+// on the next write, or only when compacted if lazy_shrink is set. shrink_divisor of 0 never shrinks.
+class Resize_Policy {
+private:
+    std::string name;
+    double growth_factor;
+    std::size_t shrink_divisor;
+    std::size_t shrink_factor;
+    bool lazy_shrink;
+
+public:
+    Resize_Policy(std::string policy_name, double growth, std::size_t divisor, std::size_t factor, bool lazy);
+
+    static const Resize_Policy* standard();
+    static const Resize_Policy* find(std::string policy_name);
+
+    const std::string& getName() const;
+    bool isLazy() const;
+    std::size_t nextCapacity(std::size_t size, std::size_t capacity, std::size_t min_capacity) const;
+    std::size_t batchCapacity(std::size_t size, std::size_t capacity, std::size_t min_capacity) const;
+    std::size_t idleCapacity(std::size_t size, std::size_t capacity, std::size_t min_capacity) const;
+};
+
+#endif
@@ -0,0 +1,288 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <sstream>
+#include <algorithm>
+#include <limits>
+#include <cctype>
+#include "Series_Index.hpp"
+#include "String_Table.hpp"
+
+Series_Index::Series_Index()
+    : MIN_ARRAY_SIZE(2),
+      codes(nullptr),
+      codes_size(0),
+      num_codes(0),
+      tokens(nullptr),
+      tokens_size(0),
+      num_tokens(0),
+      seen(nullptr),
+      seen_size(0),
+      is_built(false)
+{}
+
+/*
+* Description: Builds the index from every row of the data files: the sorted list of distinct series codes,
+*              and the word postings of their series names. Replaces anything built before.
+* Input:       std::string*: file_names (data files), unsigned int: num_files (number of files).
+*/
+void Series_Index::build(std::string* file_names, unsigned int num_files){
+    clear();
+
+    std::string line;
+    std::string name;
+    std::string code;
+
+    for (unsigned int f = 0; f < num_files; f++){
+        std::ifstream file(file_names[f]);
+        while (std::getline(file, line)){
+            std::istringstream iss(line);
+
+            // Skips country name and country code, reads series name and series code.
+            iss.ignore(std::numeric_limits<std::streamsize>::max(), ',');
+            iss.ignore(std::numeric_limits<std::streamsize>::max(), ',');
+            std::getline(iss, name, ',');
+            std::getline(iss, code, ',');
+
+            // Same codes repeat for every country (and shard), only the first occurrence is indexed.
+            std::uint32_t code_id = String_Table::global().intern(code);
+            if (markSeen(code_id)){
+                addCode(code_id);
+                tokenizeName(name, code_id);
+            }
+        }
+        file.close();
+    }
+
+    // Codes sorted by text, so prefix queries are a binary search.
+    String_Table& table = String_Table::global();
+    std::sort(codes, codes + num_codes, [&table](std::uint32_t a, std::uint32_t b){
+        return table.lookup(a) < table.lookup(b);
+    });
+
+    // Postings sorted by word then code, a word repeated inside one name is kept once.
+    std::sort(tokens, tokens + num_tokens);
+    num_tokens = std::unique(tokens, tokens + num_tokens) - tokens;
+
+    delete[] seen;
+    seen = nullptr;
+    seen_size = 0;
+    is_built = true;
+}
+
+/*
+* Description: Returns whether build was called.
+* Output:      bool: true if the index is built.
+*/
+bool Series_Index::isBuilt(){
+    return is_built;
+}
+
+/*
+* Description: Prints every series code starting with prefix (if it ends with '*'), or equal to it, in sorted order.
+* Input:       std::string: prefix (e.g. "EG.CFT.*").
+* Output:      Prints matching codes on one line, failure if there are none.
+*/
+void Series_Index::findCodes(std::string prefix){
+    bool is_prefix = (!prefix.empty() && prefix.back() == '*');
+    if (is_prefix){
+        prefix.pop_back();
+    }
+
+    // First code not smaller then the prefix, every match follows it.
+    String_Table& table = String_Table::global();
+    std::uint32_t* first = std::lower_bound(codes, codes + num_codes, prefix, [&table](std::uint32_t id, const std::string& value){
+        return table.lookup(id) < value;
+    });
+
+    unsigned int start = first - codes;
+    unsigned int end = start;
+    while (end < num_codes){
+        std::string_view code = table.lookup(codes[end]);
+        bool matches = is_prefix ? (code.substr(0, prefix.size()) == prefix) : (code == prefix);
+        if (!matches){
+            break;
+        }
+        end++;
+    }
+
+    printCodes(codes + start, end - start);
+}
+
+/*
+* Description: Prints the codes of every series whose name contains all of the given words (case insensitive, whole words).
+* Input:       std::istringstream&: words (words to look for).
+* Output:      Prints matching codes on one line in sorted order, failure if there are none.
+*/
+void Series_Index::findNames(std::istringstream& words){
+    std::uint32_t* matches = nullptr;
+    unsigned int num_matches = 0;
+    bool first_word = true;
+    std::string word;
+
+    while (words >> word){
+        for (std::size_t i = 0; i < word.size(); i++){
+            word[i] = std::tolower(static_cast<unsigned char>(word[i]));
+        }
+
+        // Word that was never interned can't be in any name.
+        std::uint32_t word_id = String_Table::global().find(word);
+        std::uint64_t low = (word_id == String_Table::NOT_FOUND) ? 0 : static_cast<std::uint64_t>(word_id) << 32;
+        std::uint64_t high = low + (static_cast<std::uint64_t>(1) << 32);
+        std::uint64_t* begin = std::lower_bound(tokens, tokens + num_tokens, low);
+        std::uint64_t* end = (word_id == String_Table::NOT_FOUND) ? begin : std::lower_bound(begin, tokens + num_tokens, high);
+
+        // Postings of one word are sorted by code id, so the intersection is a single merge.
+        unsigned int count = 0;
+        if (first_word){
+            matches = new std::uint32_t[end - begin];
+            for (std::uint64_t* p = begin; p < end; p++){
+                matches[count] = static_cast<std::uint32_t>(*p);
+                count++;
+            }
+            first_word = false;
+        } else {
+            std::uint64_t* p = begin;
+            for (unsigned int i = 0; i < num_matches; i++){
+                while (p < end && static_cast<std::uint32_t>(*p) < matches[i]){
+                    p++;
+                }
+                if (p < end && static_cast<std::uint32_t>(*p) == matches[i]){
+                    matches[count] = matches[i];
+                    count++;
+                }
+            }
+        }
+        num_matches = count;
+    }
+
+    String_Table& table = String_Table::global();
+    std::sort(matches, matches + num_matches, [&table](std::uint32_t a, std::uint32_t b){
+        return table.lookup(a) < table.lookup(b);
+    });
+    printCodes(matches, num_matches);
+    delete[] matches;
+}
+
+/*
+* Description: Prints codes separated by spaces on one line, or failure if there are none.
+* Input:       uint32_t*: code_ids (codes to print), unsigned int: count (number of codes).
+*/
+void Series_Index::printCodes(std::uint32_t* code_ids, unsigned int count){
+    if (count == 0){
+        std::cout << "failure" << std::endl;
+        return;
+    }
+    for (unsigned int i = 0; i < count; i++){
+        if (i > 0){
+            std::cout << " ";
+        }
+        std::cout << String_Table::global().lookup(code_ids[i]);
+    }
+    std::cout << std::endl;
+}
+
+/*
+* Description: Splits a series name into lowercase words (runs of letters/digits), and adds a posting for each one.
+* Input:       std::string_view: name (series name), uint32_t: code_id (code of the series).
+*/
+void Series_Index::tokenizeName(std::string_view name, std::uint32_t code_id){
+    std::string word;
+    for (std::size_t i = 0; i <= name.size(); i++){
+        if (i < name.size() && std::isalnum(static_cast<unsigned char>(name[i]))){
+            word += std::tolower(static_cast<unsigned char>(name[i]));
+        } else if (!word.empty()){
+            addToken(String_Table::global().intern(word), code_id);
+            word.clear();
+        }
+    }
+}
+
+/*
+* Description: Marks a code as indexed.
+* Input:       uint32_t: code_id (code to mark).
+* Output:      bool: true if the code wasn't marked before.
+*/
+bool Series_Index::markSeen(std::uint32_t code_id){
+    // Grows the flag array by doubling until the id fits.
+    if (code_id >= seen_size){
+        std::size_t new_size = (seen_size == 0) ? 1024 : seen_size;
+        while (code_id >= new_size){
+            new_size *= 2;
+        }
+        bool* temp_seen = new bool[new_size];
+        for (std::size_t i = 0; i < new_size; i++){
+            temp_seen[i] = (i < seen_size) ? seen[i] : false;
+        }
+        delete[] seen;
+        seen = temp_seen;
+        seen_size = new_size;
+    }
+
+    if (seen[code_id]){
+        return false;
+    }
+    seen[code_id] = true;
+    return true;
+}
+
+/*
+* Description: Appends a code, doubling the array when it is full.
+* Input:       uint32_t: code_id (code to add).
+*/
+void Series_Index::addCode(std::uint32_t code_id){
+    if (num_codes >= codes_size){
+        std::size_t new_size = (codes_size == 0) ? MIN_ARRAY_SIZE : codes_size * 2;
+        std::uint32_t* temp_codes = new std::uint32_t[new_size];
+        for (unsigned int i = 0; i < num_codes; i++){
+            temp_codes[i] = codes[i];
+        }
+        delete[] codes;
+        codes = temp_codes;
+        codes_size = new_size;
+    }
+    codes[num_codes] = code_id;
+    num_codes++;
+}
+
+/*
+* Description: Appends a (word, code) posting, doubling the array when it is full.
+* Input:       uint32_t: word_id (word in the name), uint32_t: code_id (code of the series).
+*/
+void Series_Index::addToken(std::uint32_t word_id, std::uint32_t code_id){
+    if (num_tokens >= tokens_size){
+        std::size_t new_size = (tokens_size == 0) ? MIN_ARRAY_SIZE : tokens_size * 2;
+        std::uint64_t* temp_tokens = new std::uint64_t[new_size];
+        for (unsigned int i = 0; i < num_tokens; i++){
+            temp_tokens[i] = tokens[i];
+        }
+        delete[] tokens;
+        tokens = temp_tokens;
+        tokens_size = new_size;
+    }
+    tokens[num_tokens] = (static_cast<std::uint64_t>(word_id) << 32) | code_id;
+    num_tokens++;
+}
+
+/*
+* Description: Deletes all arrays and resets the index to empty.
+*/
+void Series_Index::clear(){
+    delete[] codes;
+    delete[] tokens;
+    delete[] seen;
+    codes = nullptr;
+    tokens = nullptr;
+    seen = nullptr;
+    codes_size = 0;
+    tokens_size = 0;
+    seen_size = 0;
+    num_codes = 0;
+    num_tokens = 0;
+    is_built = false;
+}
+
+Series_Index::~Series_Index(){
+    clear();
+}
@@ -0,0 +1,47 @@
+#ifndef SERIES_INDEX_H
+#define SERIES_INDEX_H
+
+#include <string>
+#include <string_view>
+#include <sstream>
+#include <cstdint>
+
+class Series_Index {
+private:
+    int MIN_ARRAY_SIZE;
+
+    // Distinct series codes (string table ids), sorted by the code text, so a prefix is one contiguous range.
+    std::uint32_t* codes;
+    std::size_t codes_size;
+    unsigned int num_codes;
+
+    // Postings of every lowercase word in the series names, packed as (word id << 32 | code id) and sorted,
+    // so all codes of one word are one contiguous range.
+    std::uint64_t* tokens;
+    std::size_t tokens_size;
+    unsigned int num_tokens;
+
+    // Codes already indexed while building (by id), each series name is only tokenized once.
+    bool* seen;
+    std::size_t seen_size;
+
+    bool is_built;
+
+    void clear();
+    void addCode(std::uint32_t code_id);
+    void addToken(std::uint32_t word_id, std::uint32_t code_id);
+    void tokenizeName(std::string_view name, std::uint32_t code_id);
+    bool markSeen(std::uint32_t code_id);
+    void printCodes(std::uint32_t* code_ids, unsigned int count);
+
+public:
+    Series_Index();
+    ~Series_Index();
+
+    void build(std::string* file_names, unsigned int num_files);
+    bool isBuilt();
+    void findCodes(std::string prefix);
+    void findNames(std::istringstream& words);
+};
+
+#endif
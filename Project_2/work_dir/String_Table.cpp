@@ -0,0 +1,216 @@
+#include <string>
+#include <string_view>
+#include <cstring>
+#include <stdexcept>
+#include "String_Table.hpp"
+
+String_Table::String_Table()
+    : PAGE_SIZE(4096),
+      MAX_PAGES(4096),
+      CHUNK_SIZE(1 << 16),
+      MIN_TABLE_SIZE(1024),
+      pages(nullptr),
+      num_strings(0),
+      chunks(nullptr),
+      num_chunks(0),
+      chunks_size(0),
+      chunk_used(0),
+      slots(nullptr),
+      table_size(0)
+{
+    pages = new Entry*[MAX_PAGES];
+    for (std::size_t i = 0; i < MAX_PAGES; i++){
+        pages[i] = nullptr;
+    }
+
+    table_size = MIN_TABLE_SIZE;
+    slots = new std::uint32_t[table_size];
+    for (std::size_t i = 0; i < table_size; i++){
+        slots[i] = 0;
+    }
+
+    // Empty string always has id 0, which is what a default constructed series uses.
+    intern("");
+}
+
+/*
+* Description: Returns the table shared by the whole program. Names and codes read from the data file are interned here once,
+*              and every series refers to them by id.
+* Output:      String_Table&: global table.
+*/
+String_Table& String_Table::global(){
+    static String_Table table;
+    return table;
+}
+
+/*
+* Description: FNV-1a hash of a string.
+* Input:       std::string_view: str (string to hash).
+* Output:      uint64_t: hash value.
+*/
+std::uint64_t String_Table::hash(std::string_view str){
+    std::uint64_t h = 14695981039346656037ULL;
+    for (std::size_t i = 0; i < str.size(); i++){
+        h ^= static_cast<unsigned char>(str[i]);
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+/*
+* Description: Returns the id of a string, adding it to the table if it isn't stored yet.
+* Input:       std::string_view: str (string to intern).
+* Output:      uint32_t: id of the string.
+*/
+std::uint32_t String_Table::intern(std::string_view str){
+    std::lock_guard<std::mutex> guard(table_lock);
+
+    std::size_t mask = table_size - 1;
+    std::size_t slot = hash(str) & mask;
+
+    // Linear probing until the string or an empty slot is found.
+    while (slots[slot] != 0){
+        std::uint32_t id = slots[slot] - 1;
+        if (lookup(id) == str){
+            return id;
+        }
+        slot = (slot + 1) & mask;
+    }
+
+    if (num_strings >= PAGE_SIZE * MAX_PAGES){
+        throw std::length_error("String_Table is full");
+    }
+
+    // Stores new entry, allocating its page if it is the first entry of the page.
+    std::uint32_t id = num_strings;
+    std::size_t page = id / PAGE_SIZE;
+    if (pages[page] == nullptr){
+        pages[page] = new Entry[PAGE_SIZE];
+    }
+    pages[page][id % PAGE_SIZE].chars = storeChars(str);
+    pages[page][id % PAGE_SIZE].length = str.size();
+    num_strings++;
+
+    slots[slot] = id + 1;
+
+    // Keeps table at most half full, so probes stay short.
+    if (num_strings * 2 > table_size){
+        resizeTable(table_size * 2);
+    }
+    return id;
+}
+
+/*
+* Description: Returns the id of a string without adding it.
+* Input:       std::string_view: str (string to find).
+* Output:      uint32_t: id of the string, NOT_FOUND if it was never interned.
+*/
+std::uint32_t String_Table::find(std::string_view str){
+    std::lock_guard<std::mutex> guard(table_lock);
+
+    std::size_t mask = table_size - 1;
+    std::size_t slot = hash(str) & mask;
+
+    while (slots[slot] != 0){
+        std::uint32_t id = slots[slot] - 1;
+        if (lookup(id) == str){
+            return id;
+        }
+        slot = (slot + 1) & mask;
+    }
+    return NOT_FOUND;
+}
+
+/*
+* Description: Returns the characters of an interned string. The view stays valid for the lifetime of the table.
+* Input:       uint32_t: id (id returned by intern).
+* Output:      std::string_view: the string.
+*/
+std::string_view String_Table::lookup(std::uint32_t id){
+    Entry& entry = pages[id / PAGE_SIZE][id % PAGE_SIZE];
+    return std::string_view(entry.chars, entry.length);
+}
+
+/*
+* Description: Returns the number of interned strings.
+* Output:      uint32_t: number of strings.
+*/
+std::uint32_t String_Table::size(){
+    return num_strings;
+}
+
+/*
+* Description: Copies characters of a string into the current chunk, starting a new chunk if it doesn't fit.
+*              Strings longer then a chunk get a chunk of their own.
+* Input:       std::string_view: str (string to copy).
+* Output:      const char*: location of the copy.
+*/
+const char* String_Table::storeChars(std::string_view str){
+    bool fits = (num_chunks > 0 && chunk_used + str.size() <= CHUNK_SIZE);
+
+    if (!fits){
+        // Grows the list of chunks by doubling, same as the other dynamic arrays.
+        if (num_chunks >= chunks_size){
+            std::size_t new_size = (chunks_size == 0) ? 16 : chunks_size * 2;
+            char** temp_chunks = new char*[new_size];
+            for (std::size_t i = 0; i < num_chunks; i++){
+                temp_chunks[i] = chunks[i];
+            }
+            delete[] chunks;
+            chunks = temp_chunks;
+            chunks_size = new_size;
+        }
+
+        std::size_t size = (str.size() > CHUNK_SIZE) ? str.size() : CHUNK_SIZE;
+        chunks[num_chunks] = new char[size];
+        num_chunks++;
+        chunk_used = 0;
+    }
+
+    char* location = chunks[num_chunks - 1] + chunk_used;
+    std::memcpy(location, str.data(), str.size());
+    chunk_used += str.size();
+
+    // Oversized string filled its own chunk, the next string starts a new one.
+    if (str.size() > CHUNK_SIZE){
+        chunk_used = CHUNK_SIZE;
+    }
+    return location;
+}
+
+/*
+* Description: Rebuilds the hash table with a new size (power of 2).
+* Input:       size_t: new_size (number of slots).
+*/
+void String_Table::resizeTable(std::size_t new_size){
+    std::uint32_t* temp_slots = new std::uint32_t[new_size];
+    for (std::size_t i = 0; i < new_size; i++){
+        temp_slots[i] = 0;
+    }
+
+    std::size_t mask = new_size - 1;
+    for (std::uint32_t id = 0; id < num_strings; id++){
+        std::size_t slot = hash(lookup(id)) & mask;
+        while (temp_slots[slot] != 0){
+            slot = (slot + 1) & mask;
+        }
+        temp_slots[slot] = id + 1;
+    }
+
+    delete[] slots;
+    slots = temp_slots;
+    table_size = new_size;
+}
+
+String_Table::~String_Table(){
+    for (std::size_t i = 0; i < MAX_PAGES; i++){
+        delete[] pages[i];
+    }
+    delete[] pages;
+
+    for (std::size_t i = 0; i < num_chunks; i++){
+        delete[] chunks[i];
+    }
+    delete[] chunks;
+    delete[] slots;
+}
@@ -0,0 +1,57 @@
+#ifndef STRING_TABLE_H
+#define STRING_TABLE_H
+
+#include <string>
+#include <string_view>
+#include <cstdint>
+#include <mutex>
+
+class String_Table {
+private:
+    struct Entry {
+        const char* chars;
+        std::uint32_t length;
+    };
+
+    std::size_t PAGE_SIZE;
+    std::size_t MAX_PAGES;
+    std::size_t CHUNK_SIZE;
+    int MIN_TABLE_SIZE;
+
+    // Entries are stored in fixed size pages that never move, so views returned by lookup stay valid.
+    Entry** pages;
+    std::uint32_t num_strings;
+
+    // Characters of every string are copied into large chunks instead of one allocation per string.
+    char** chunks;
+    std::size_t num_chunks;
+    std::size_t chunks_size;
+    std::size_t chunk_used;
+
+    // Open addressing hash table of ids (slot value is id + 1, 0 means empty).
+    std::uint32_t* slots;
+    std::size_t table_size;
+
+    // Countries can be loaded on a background thread, so intern/find are serialized.
+    // lookup needs no lock: pages never move, and ids are only handed out after their entry is written.
+    std::mutex table_lock;
+
+    static std::uint64_t hash(std::string_view str);
+    const char* storeChars(std::string_view str);
+    void resizeTable(std::size_t new_size);
+
+public:
+    static const std::uint32_t NOT_FOUND = 0xFFFFFFFF;
+
+    String_Table();
+    ~String_Table();
+
+    static String_Table& global();
+
+    std::uint32_t intern(std::string_view str);
+    std::uint32_t find(std::string_view str);
+    std::string_view lookup(std::uint32_t id);
+    std::uint32_t size();
+};
+
+#endif
@@ -0,0 +1,181 @@
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include "Task_Pool.hpp"
+
+Task_Pool::Task_Pool(unsigned int num_workers)
+    : worker_count(num_workers),
+      workers(nullptr),
+      queues(nullptr),
+      queue_count(num_workers + 1),
+      pending(0),
+      stopping(false)
+{
+    queues = new Work_Queue[queue_count];
+
+    // Starts worker threads, each one owns the queue with the same index.
+    if (worker_count > 0){
+        workers = new std::thread[worker_count];
+        for (unsigned int i = 0; i < worker_count; i++){
+            workers[i] = std::thread(&Task_Pool::workerLoop, this, i);
+        }
+    }
+}
+
+/*
+* Description: Returns the pool shared by the whole program. It has one worker less then the number of hardware threads,
+*              since the thread calling parallelFor also runs tasks.
+* Output:      Task_Pool&: shared pool.
+*/
+Task_Pool& Task_Pool::shared(){
+    static Task_Pool pool(std::thread::hardware_concurrency() > 1 ? std::thread::hardware_concurrency() - 1 : 0);
+    return pool;
+}
+
+/*
+* Description: Returns the number of worker threads (not counting the calling thread).
+* Output:      unsigned int: number of workers.
+*/
+unsigned int Task_Pool::getWorkerCount(){
+    return worker_count;
+}
+
+/*
+* Description: Runs body over [0, count) split into ranges, and returns once every range finished.
+*              Ranges are handed out round robin into the worker queues, and idle threads steal from the other queues.
+*              Runs everything on the calling thread if there are no workers or the work fits in one range.
+*              If a range throws, ranges that have not started yet are skipped, and the exception is rethrown here once
+*              every running range is done.
+* Input:       size_t: count (number of items), size_t: grain (smallest range given to a single task),
+*              function: body (called with [begin, end) of each range, must only write to items in its own range).
+*/
+void Task_Pool::parallelFor(std::size_t count, std::size_t grain, const std::function<void(std::size_t, std::size_t)>& body){
+    if (count == 0){
+        return;
+    }
+    if (grain == 0){
+        grain = 1;
+    }
+    if (worker_count == 0 || count <= grain){
+        body(0, count);
+        return;
+    }
+
+    // Uses about 4 ranges per thread, so stealing can even out ranges that take longer then others.
+    std::size_t chunk = (count + 4 * queue_count - 1) / (4 * queue_count);
+    if (chunk < grain){
+        chunk = grain;
+    }
+    std::size_t num_tasks = (count + chunk - 1) / chunk;
+    Batch batch;
+    batch.remaining = num_tasks;
+    batch.failed = false;
+
+    // Counted before the tasks are queued, so a worker taking one early never sees the counter go below zero.
+    pending += num_tasks;
+
+    for (std::size_t t = 0; t < num_tasks; t++){
+        Task task;
+        task.body = &body;
+        task.begin = t * chunk;
+        task.end = (task.begin + chunk < count) ? task.begin + chunk : count;
+        task.batch = &batch;
+
+        Work_Queue& queue = queues[t % queue_count];
+        std::lock_guard<std::mutex> guard(queue.lock);
+        queue.tasks.push_back(task);
+    }
+
+    // Wakes up sleeping workers.
+    {
+        std::lock_guard<std::mutex> guard(sleep_lock);
+    }
+    sleep_cv.notify_all();
+
+    // Calling thread works through the tasks as well, until every range (including the ones running on workers) is done.
+    while (batch.remaining.load() > 0){
+        if (!runOneTask(worker_count)){
+            std::this_thread::yield();
+        }
+    }
+
+    if (batch.failed.load()){
+        std::rethrow_exception(batch.error);
+    }
+}
+
+/*
+* Description: Runs a single task. Takes the newest task of the home queue first, otherwise steals the oldest task of another queue.
+* Input:       unsigned int: home (index of the queue owned by the calling thread).
+* Output:      bool: true if a task was run.
+*/
+bool Task_Pool::runOneTask(unsigned int home){
+    Task task;
+    bool found = false;
+
+    for (unsigned int i = 0; i < queue_count && !found; i++){
+        Work_Queue& queue = queues[(home + i) % queue_count];
+        std::lock_guard<std::mutex> guard(queue.lock);
+        if (queue.tasks.empty()){
+            continue;
+        }
+        if (i == 0){
+            task = queue.tasks.back();
+            queue.tasks.pop_back();
+        } else {
+            task = queue.tasks.front();
+            queue.tasks.pop_front();
+        }
+        found = true;
+    }
+
+    if (!found){
+        return false;
+    }
+
+    pending--;
+    // The task counts as done even if it throws, otherwise parallelFor would wait for it forever.
+    if (!task.batch->failed.load()){
+        try {
+            (*task.body)(task.begin, task.end);
+        } catch (...){
+            std::lock_guard<std::mutex> guard(task.batch->error_lock);
+            if (!task.batch->failed.load()){
+                task.batch->error = std::current_exception();
+                task.batch->failed = true;
+            }
+        }
+    }
+    task.batch->remaining.fetch_sub(1);
+    return true;
+}
+
+/*
+* Description: Main loop of a worker thread. Runs tasks while there are any, and sleeps when every queue is empty.
+* Input:       unsigned int: home (index of the queue owned by the worker).
+*/
+void Task_Pool::workerLoop(unsigned int home){
+    while (!stopping.load()){
+        if (runOneTask(home)){
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleep_lock);
+        sleep_cv.wait(lock, [this]{ return stopping.load() || pending.load() > 0; });
+    }
+}
+
+Task_Pool::~Task_Pool(){
+    {
+        std::lock_guard<std::mutex> guard(sleep_lock);
+        stopping = true;
+    }
+    sleep_cv.notify_all();
+
+    for (unsigned int i = 0; i < worker_count; i++){
+        workers[i].join();
+    }
+    delete[] workers;
+    delete[] queues;
+}
@@ -0,0 +1,59 @@
+#ifndef TASK_POOL_H
+#define TASK_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+class Task_Pool {
+private:
+    // Shared by the tasks of one parallelFor call. The first exception thrown by a range is kept and rethrown on the caller.
+    struct Batch {
+        std::atomic<std::size_t> remaining;
+        std::atomic<bool> failed;
+        std::exception_ptr error;
+        std::mutex error_lock;
+    };
+
+    struct Task {
+        const std::function<void(std::size_t, std::size_t)>* body;
+        std::size_t begin;
+        std::size_t end;
+        Batch* batch;
+    };
+
+    struct Work_Queue {
+        std::mutex lock;
+        std::deque<Task> tasks;
+    };
+
+    unsigned int worker_count;
+    std::thread* workers;
+
+    // One queue per worker, plus one for threads calling parallelFor.
+    Work_Queue* queues;
+    unsigned int queue_count;
+
+    std::atomic<std::size_t> pending;
+    std::atomic<bool> stopping;
+    std::mutex sleep_lock;
+    std::condition_variable sleep_cv;
+
+    void workerLoop(unsigned int home);
+    bool runOneTask(unsigned int home);
+
+public:
+    Task_Pool(unsigned int num_workers);
+    ~Task_Pool();
+
+    static Task_Pool& shared();
+
+    void parallelFor(std::size_t count, std::size_t grain, const std::function<void(std::size_t, std::size_t)>& body);
+    unsigned int getWorkerCount();
+};
+
+#endif
@@ -3,6 +3,8 @@
 #include <string>
 #include <sstream>
 #include <cassert>
+#include <algorithm>
+#include <limits>
 #include "Time_Series.hpp"
 
 Time_Series::Time_Series()
@@ -10,14 +12,22 @@ Time_Series::Time_Series()
       FIRST_YEAR(1960),
       LAST_YEAR(2023),
       MISSING_DATA_INDICATOR(-1.0),
-      series_name(""),
-      series_code(""),
+      series_name_id(0),
+      series_code_id(0),
+      buffer(nullptr),
       years(nullptr),
       data(nullptr),
       array_size(0),
-      last_idx(0)
+      last_idx(0),
+      policy(Resize_Policy::standard())
 {}
 
+Time_Series::Time_Series(const Time_Series& other)
+    : Time_Series()
+{
+    *this = other;
+}
+
 /*
 * Description: Load csv file series data.
 *              Loads first 4 lines of csv file including series name and series code.
@@ -25,27 +35,23 @@ Time_Series::Time_Series()
 * Input:       std::string: filename
 */
 void Time_Series::load(std::istringstream& input_line){
-    // Deletes array, and reinitializes all variables related to file size/capacity, to prevent memory leaks.
-    delete[] years; 
-    years = nullptr;
-    delete[] data;
-    data  = nullptr;
+    // Releases arrays, and reinitializes all variables related to file size/capacity, to prevent memory leaks.
+    releaseBuffer();
 
     array_size = MIN_ARRAY_SIZE;
     last_idx = 0;
 
     // Initializes new arrays which will contain series data.
-    years = new int[array_size];
-    data = new double[array_size];
+    allocateBuffer(array_size);
 
     std::stringstream ss;
     std::string line;
 
-    // Reads first 2 entries of line, which contain the series name and the series code.
-    std::getline(input_line, series_name, ',');
-    // std::cout << series_name << std::endl;
-    std::getline(input_line, series_code, ',');
-    // std::cout << series_code << std::endl;
+    // Reads first 2 entries of line, which contain the series name and the series code, and stores them as interned ids.
+    std::getline(input_line, line, ',');
+    series_name_id = String_Table::global().intern(line);
+    std::getline(input_line, line, ',');
+    series_code_id = String_Table::global().intern(line);
 
     // Reads data stored in csv and stores it in the arrays. Reads until runs out of file space.
     while (std::getline(input_line, line, ',')){
@@ -67,21 +73,37 @@ void Time_Series::load(std::istringstream& input_line){
 *              Prints failure if no valid data entries.
 */
 void Time_Series::print(){
+    // Rendered text is kept with the arrays until the next write to them, so repeated prints are one write.
+    if (buffer != nullptr && buffer->rendered != nullptr){
+        std::cout.write(buffer->rendered->data(), buffer->rendered->size());
+        std::cout << std::endl;
+        return;
+    }
+
+    std::ostringstream rendered;
+
     // Sets numValidData variable to 0.
     int numValidData = 0;
     for (size_t i = 0; i < last_idx; i++){
         // If data entry is invalid then don't print series element.
         if (data[i] != MISSING_DATA_INDICATOR){
             numValidData++; // Increases by 1, to ensure program knows there is valid data in series.
-            std::cout << "(" << years[i] << "," << data[i] << ") ";
+            rendered << "(" << years[i] << "," << data[i] << ") ";
         }
     }
 
     // If no valid data, then print failure.
     if (numValidData == 0){
-        std::cout << "failure";
+        rendered << "failure";
     }
+
+    std::string text = rendered.str();
+    std::cout.write(text.data(), text.size());
     std::cout << std::endl;
+
+    if (buffer != nullptr){
+        buffer->rendered = new std::string(text);
+    }
 }
 
 /*
@@ -93,8 +115,9 @@ void Time_Series::print(){
 * Output:      Prints failure if updated data value is below 0. 
 *              Print failure if series element does not exist.
 *              Print success if series element exists, and data value above 0.
+*              bool: true if the series was changed.
 */
-void Time_Series::update(int year, double datum){
+bool Time_Series::update(int year, double datum){
     // Return series element index.
     int idx = returnYearIdx(year);
 
@@ -105,12 +128,15 @@ void Time_Series::update(int year, double datum){
             removeSeriesElement(idx);
             std::cout << "success" << std::endl;
         } else {
+            detachBuffer();
             data[idx] = datum;
             std::cout << "success" << std::endl;
         }
+        return true;
     }
     else {
         std::cout << "failure" << std::endl;
+        return false;
     }
 }
 
@@ -232,17 +258,36 @@ bool Time_Series::is_monotonic() {
 * Output:      bool: return true, if valid data exists, false if no valid data.
 */
 bool Time_Series::best_fit(double &m, double &b){
+    // If valid data exists then return true and print the slope/bias to console.
+    if (fitLine(m, b)){
+        std::cout << "slope is " + std::to_string(m) + " intercept is " + std::to_string(b) << std::endl;
+        return true;
+    }
+
+    // If no valid data print failure and return false.
+    std::cout << "failure" << std::endl;
+    return false;
+}
+
+/*
+* Description: Computes the linear function of best fit (y = mx + b) for the series, without printing anything.
+*              Used by best_fit, and by whole country scans that run on several threads at once.
+* Input:       double&: m (slope of best fit function), double&: b (bias of best fit function).
+* Output:      bool: return true, if valid data exists, false if no valid data (m, b are then 0).
+*/
+bool Time_Series::fitLine(double &m, double &b){
     // Sets variables to initial values.
     m = 0;
     b = 0;
     
-    int numValidData = 0;
+    long long numValidData = 0;
 
-    // Declare member variables.
-    int sigma_xi = 0;
+    // Declare member variables. Sums of years are 64 bit: the sum of squared years overflows int past ~500 points,
+    // and n * sum of squares / (sum of years)^2 past ~23, so they are kept exact in long long.
+    long long sigma_xi = 0;
     double sigma_yi = 0;
     double dot_sigma_x_y = 0;
-    int sigma_x_squared = 0;
+    long long sigma_x_squared = 0;
 
     // Loops through entire series, iterate all the necessary variables which are part of the best fit function.
     for (int i = 0; i < last_idx; i++){
@@ -251,31 +296,25 @@ bool Time_Series::best_fit(double &m, double &b){
             sigma_xi += years[i];
             sigma_yi += data[i];
             dot_sigma_x_y += years[i] * data[i];
-            sigma_x_squared += years[i] * years[i];
+            sigma_x_squared += static_cast<long long>(years[i]) * years[i];
         }
     }
 
-    // If valid data exists then return true and print the slope/bias to console.
-    if (numValidData > 0){
-        // Use the best fit formula to compute the values of m and b.
-        m = (numValidData * dot_sigma_x_y - sigma_xi * sigma_yi)/(numValidData * sigma_x_squared - sigma_xi * sigma_xi);
-        b = (sigma_yi - m * sigma_xi)/numValidData;   
-        std::cout << "slope is " + std::to_string(m) + " intercept is " + std::to_string(b) << std::endl;
-        return true;
+    if (numValidData == 0){
+        return false;
     }
 
-    // If no valid data print failure and return false.
-    std::cout << "failure" << std::endl;
-    return false;
+    // Use the best fit formula to compute the values of m and b.
+    m = (numValidData * dot_sigma_x_y - sigma_xi * sigma_yi)/(numValidData * sigma_x_squared - sigma_xi * sigma_xi);
+    b = (sigma_yi - m * sigma_xi)/numValidData;   
+    return true;
 }
 
 /*
 * Description: Add a element to series, and whether or not operation is successful, print to console, either success or failure.
+* Output:      bool: true if the element was added.
 */
-void Time_Series::add(int year, double datum){
-    // Checks whether has reached max capacity, and resizes if needed.
-    checkAndResizeSeries();
-
+bool Time_Series::add(int year, double datum){
     // Add element to series, and if operation succesful, prints success, otherwise prints failure.
     bool flag = addSeriesElement(year, datum);
     if(!flag){
@@ -283,6 +322,145 @@ void Time_Series::add(int year, double datum){
     } else {
         std::cout << "success" << std::endl;
     }
+    return flag;
+}
+
+/*
+* Description: Applies a batch of ADD_P2 (is_update false) or UPDATE_P2 (is_update true) operations in one pass.
+*              Operations are sorted by year (keeping input order for equal years), applied to each year in order,
+*              and the result is merged with the existing arrays, with at most one new allocation.
+*              results[i] is what applying operation i with add/update one by one would have reported.
+*              Capacity is chosen once for the final size, using the same resize policy as checkAndResizeSeries.
+* Input:       int*: in_years, double*: in_data (the operations), unsigned int: count (number of operations),
+*              bool: is_update (type of the operations), bool*: results (success of each operation).
+*/
+void Time_Series::mergeElements(int* in_years, double* in_data, unsigned int count, bool is_update, bool* results){
+    if (count == 0){
+        return;
+    }
+
+    // Sorts operation indexes by year, ties by position in the batch.
+    unsigned int* order = new unsigned int[count];
+    for (unsigned int i = 0; i < count; i++){
+        order[i] = i;
+    }
+    std::sort(order, order + count, [in_years](unsigned int a, unsigned int b){
+        if (in_years[a] != in_years[b]){
+            return in_years[a] < in_years[b];
+        }
+        return a < b;
+    });
+
+    // Final state of every distinct year in the batch.
+    unsigned int num_groups = 0;
+    int* group_year = new int[count];
+    double* group_value = new double[count];
+    bool* group_present = new bool[count];
+    int* group_idx = new int[count];        // index of the year in the current series, -1 if it isn't stored
+
+    unsigned int new_size = last_idx;
+    bool structure_changed = false;
+    unsigned int j = 0;
+
+    for (unsigned int i = 0; i < count; ){
+        int year = in_years[order[i]];
+
+        // Walks the series forward to this year (both are sorted).
+        while (j < last_idx && years[j] < year){
+            j++;
+        }
+        bool existed = (j < last_idx && years[j] == year);
+        bool present = existed;
+        double value = existed ? data[j] : MISSING_DATA_INDICATOR;
+
+        // Applies every operation on this year, in batch order, same rules as addSeriesElement/update.
+        for (; i < count && in_years[order[i]] == year; i++){
+            double datum = in_data[order[i]];
+            bool success = false;
+            if (!is_update){
+                if (!present || value == MISSING_DATA_INDICATOR){
+                    present = true;
+                    value = datum;
+                    success = true;
+                }
+            } else if (present && value != MISSING_DATA_INDICATOR){
+                if (datum < 0){
+                    present = false;
+                } else {
+                    value = datum;
+                }
+                success = true;
+            }
+            results[order[i]] = success;
+        }
+
+        group_year[num_groups] = year;
+        group_value[num_groups] = value;
+        group_present[num_groups] = present;
+        group_idx[num_groups] = existed ? j : -1;
+        num_groups++;
+
+        if (existed && !present){
+            new_size--;
+            structure_changed = true;
+        } else if (!existed && present){
+            new_size++;
+            structure_changed = true;
+        }
+    }
+
+    if (!structure_changed){
+        // Only values changed, so they are written in place.
+        detachBuffer();
+        for (unsigned int g = 0; g < num_groups; g++){
+            if (group_idx[g] >= 0){
+                data[group_idx[g]] = group_value[g];
+            }
+        }
+    } else {
+        // Picks the capacity for the final size once.
+        std::size_t new_capacity = policy->batchCapacity(new_size, array_size, MIN_ARRAY_SIZE);
+
+        Series_Buffer* old_buffer = buffer;
+        int* old_years = years;
+        double* old_data = data;
+        unsigned int old_size = last_idx;
+        buffer = nullptr;
+        allocateBuffer(new_capacity);
+
+        // Merges old entries with the final state of the batch years.
+        unsigned int out = 0;
+        unsigned int g = 0;
+        for (unsigned int k = 0; k < old_size || g < num_groups; ){
+            if (g < num_groups && (k >= old_size || group_year[g] <= old_years[k])){
+                if (group_present[g]){
+                    years[out] = group_year[g];
+                    data[out] = group_value[g];
+                    out++;
+                }
+                // Old entry of the same year is replaced by the batch result.
+                if (k < old_size && old_years[k] == group_year[g]){
+                    k++;
+                }
+                g++;
+            } else {
+                years[out] = old_years[k];
+                data[out] = old_data[k];
+                out++;
+                k++;
+            }
+        }
+
+        dropReference(old_buffer);
+        array_size = new_capacity;
+        last_idx = out;
+    }
+
+    delete[] group_idx;
+    delete[] group_present;
+    delete[] group_value;
+    delete[] group_year;
+    delete[] order;
 }
 
 /*
@@ -293,6 +471,7 @@ void Time_Series::add(int year, double datum){
 void Time_Series::addSeriesLoad(int year, double datum){
     // Checks wether function needs to be resized or not.
     checkAndResizeSeries();
+    detachBuffer();
 
     // Adds series element with appropriate year, and datum value
     years[last_idx] = year;
@@ -301,6 +480,39 @@ void Time_Series::addSeriesLoad(int year, double datum){
     last_idx++;
 }
 
+/*
+* Description: Merges the data points of another series for years after after_year, e.g. when the data file gains a new year
+*              column. A year is merged the same way ADD_P2 adds it: only if this series has no valid data for it, so values
+*              changed or added in memory are kept, wherever they are. Years up to after_year were read before and are skipped,
+*              so years removed from this series aren't read back.
+* Input:       Time_Series&: other (series with the same code, read from the data file), int: after_year.
+* Output:      unsigned int: number of data points merged.
+*/
+unsigned int Time_Series::mergeFileYears(Time_Series& other, int after_year){
+    int* in_years = new int[other.last_idx + 1];
+    double* in_data = new double[other.last_idx + 1];
+    unsigned int count = 0;
+    for (unsigned int i = 0; i < other.last_idx; i++){
+        if (other.years[i] > after_year){
+            in_years[count] = other.years[i];
+            in_data[count] = other.data[i];
+            count++;
+        }
+    }
+
+    bool* results = new bool[count + 1];
+    mergeElements(in_years, in_data, count, false, results);
+    unsigned int merged = 0;
+    for (unsigned int i = 0; i < count; i++){
+        merged += results[i];
+    }
+
+    delete[] results;
+    delete[] in_data;
+    delete[] in_years;
+    return merged;
+}
+
 /*
 * Description: Add a element (year,data) to series.
 *              If series entry does not exist, or it does but it has negative value, add entry to series.
@@ -308,11 +520,14 @@ void Time_Series::addSeriesLoad(int year, double datum){
 * Output:      bool: isSucces (outputs true if successfully added value, false otherwise)
 */
 bool Time_Series::addSeriesElement(int year, double datum){
-    // Checks if series array is at full capacity
-    checkAndResizeSeries();
-
     // Returns index of entry which has this year (if none exists, outputs either -1 or nearest index less then input year)
     int value_idx = returnYearIdx(year);
+
+    // Capacity used to be checked by add, here, and again by insertSeriesElement. The same number of policy steps is applied
+    // up front instead, so capacities stay the same but the series is reallocated at most once. 3 and 2 passes are kept only
+    // for output compatibility: TS_P2 reports the capacity, and one pass would change it.
+    bool inserting = (value_idx < 0 || years[value_idx] != year);
+    resizeForWrite(inserting ? 3 : 2);
     
     // If value_idx < 0, means input year is less then smallest entry in series.
     // If an index is returned, but entry does not currently exist at that index, insert entry right after returned index.
@@ -327,6 +542,7 @@ bool Time_Series::addSeriesElement(int year, double datum){
         return true;
     } else if (years[value_idx] == year && data[value_idx] == MISSING_DATA_INDICATOR){
         // Update entry with valid data
+        detachBuffer();
         data[value_idx] = datum;
         return true;
     } 
@@ -338,6 +554,8 @@ bool Time_Series::addSeriesElement(int year, double datum){
 * Input:       int: idx (index of element to be removed).
 */
 void Time_Series::removeSeriesElement(int idx){
+    detachBuffer();
+
     // Loops through array after the index to be removed, thus shifting all the values down by one.
     for (int i = idx + 1; i < last_idx; i++){
         years[i - 1] = years[i];
@@ -353,28 +571,24 @@ void Time_Series::removeSeriesElement(int idx){
 * Input:       int: year (entry year), double: datum (data to be added), size_t: element_idx (idx of element to be added)
 */
 void Time_Series::insertSeriesElement(int year, double datum, size_t element_idx){
-    // Checks and resizes series, in case it is at max capacity.
-    checkAndResizeSeries();
-
-    // Increase last_idx variable.
-    last_idx++;
-
-    // Set the new last entries to a temporary value of zero.
-    years[last_idx] = 0;
-    data[last_idx] = 0;
-
-    // Declare temporary variables.
-    int temp_year = 0;
-    int temp_datum = 0;
-
-    // Shift all values of series to the right by one.
-    for (unsigned int i = element_idx + 1; i < last_idx; i++){
-        temp_year = years[i];
-        temp_datum = data[i];
+    // Callers make room first (see addSeriesElement), this only grows the series if they didn't.
+    if (last_idx >= array_size){
+        checkAndResizeSeries();
+    }
+    detachBuffer();
 
+    // Shift all values of series, from element_idx onwards, to the right by one.
+    for (unsigned int i = last_idx; i > element_idx; i--){
         years[i] = years[i - 1];
         data[i] = data[i - 1];
     }
+
+    // Store new entry in the free position.
+    years[element_idx] = year;
+    data[element_idx] = datum;
+
+    // Increase last_idx variable.
+    last_idx++;
 }
 
 /*
@@ -384,21 +598,59 @@ void Time_Series::insertSeriesElement(int year, double datum, size_t element_idx
 * Output:      bool: Whether function was resized or not.
 */
 bool Time_Series::checkAndResizeSeries(){  
-    bool flag = false;
+    return resizeForWrite(1);
+}
+
+/*
+* Description: Applies the resize policy a number of times (as that many capacity checks in a row would), then resizes once.
+* Input:       unsigned int: passes (number of capacity checks to apply).
+* Output:      bool: Whether series was resized or not.
+*/
+bool Time_Series::resizeForWrite(unsigned int passes){
     size_t new_size = array_size;
+    for (unsigned int i = 0; i < passes; i++){
+        new_size = policy->nextCapacity(last_idx, new_size, MIN_ARRAY_SIZE);
+    }
+
+    if (new_size == array_size){
+        return false;
+    }
+    resizeSeries(new_size);
+    return true;
+}
 
-    // If statement checks if series needs to be resized.
-    if (last_idx >= array_size){ // If ran out of array capacity double array size.
-        new_size = array_size * 2;
-        flag = true;
-        resizeSeries(new_size);
-    } else if (last_idx <= array_size/4 && last_idx != 0){ // If array size is 4 times larger then array capacity resize it.
-        new_size = array_size/2;
-        flag = true;
-        resizeSeries(new_size);
+/*
+* Description: Shrinks the series the way its policy does when idle (lazy policies only shrink here).
+* Output:      bool: Whether series was resized or not.
+*/
+bool Time_Series::compact(){
+    size_t new_size = policy->idleCapacity(last_idx, array_size, MIN_ARRAY_SIZE);
+    if (new_size == array_size){
+        return false;
     }
+    resizeSeries(new_size);
+    return true;
+}
 
-    return flag;
+/*
+* Description: Shrinks the capacity of the series to its size (at least MIN_ARRAY_SIZE).
+* Output:      bool: Whether series was resized or not.
+*/
+bool Time_Series::shrinkToFit(){
+    size_t new_size = (last_idx > static_cast<unsigned int>(MIN_ARRAY_SIZE)) ? last_idx : MIN_ARRAY_SIZE;
+    if (buffer == nullptr || new_size == array_size){
+        return false;
+    }
+    resizeSeries(new_size);
+    return true;
+}
+
+/*
+* Description: Sets the policy used to pick the capacity of the series.
+* Input:       const Resize_Policy*: new_policy (policy to use, see Resize_Policy::find).
+*/
+void Time_Series::setPolicy(const Resize_Policy* new_policy){
+    policy = new_policy;
 }
 
 /*
@@ -406,23 +658,23 @@ bool Time_Series::checkAndResizeSeries(){
 * Input:       size_t&: new_size (new array size).
 */
 void Time_Series::resizeSeries(size_t& new_size){
-    // Declare two new temporary arrays with size new_size.
-    int* temp_years = new int[new_size];
-    double* temp_data = new double[new_size];
+    // Keeps old arrays until the values are copied over (they may still be shared with a snapshot).
+    Series_Buffer* old_buffer = buffer;
+    int* old_years = years;
+    double* old_data = data;
+    buffer = nullptr;
+
+    // Declare two new arrays with size new_size.
+    allocateBuffer(new_size);
 
     // Copy all array values into new array.
     for (unsigned int i = 0; i < last_idx; i++){
-        temp_years[i] = years[i];
-        temp_data[i] = data[i];
+        years[i] = old_years[i];
+        data[i] = old_data[i];
     }
 
-    // Delete pointers to old arrays to prevent memory leaks
-    delete[] years;
-    delete[] data;
-
-    // Reassign array points to new arrays.
-    years = temp_years;
-    data = temp_data;
+    // Release old arrays to prevent memory leaks
+    dropReference(old_buffer);
 
     // Set array_size to new value.
     array_size = new_size;
@@ -430,14 +682,14 @@ void Time_Series::resizeSeries(size_t& new_size){
 
 /*
 * Description: Use binary search to return index of year in the series.
-*              If year is less then first year value in series, then return -1.
+*              If series is empty, or year is less then first year value in series, then return -1.
 *              If year is not in series return index of largest year smaller then the input year.
 * Input:       int: year (year to be found)
 * Output:      int: idx (idx of year in series)
 */
 int Time_Series::returnYearIdx(int year){
-    // If input year less then first year return -1.
-    if (year < years[0]){
+    // If series is empty, or input year less then first year return -1.
+    if (last_idx == 0 || year < years[0]){
         return -1;
     }
     
@@ -462,19 +714,27 @@ int Time_Series::returnYearIdx(int year){
 }
 
 /*
-* Description: Returns the name of the series
-* Output:      std::string: Name of the series.
+* Description: Returns the name of the series (view into the global string table, no copy is made).
+* Output:      std::string_view: Name of the series.
 */
-std::string Time_Series::getSeriesName(){
-    return series_name;
+std::string_view Time_Series::getSeriesName(){
+    return String_Table::global().lookup(series_name_id);
 }
 
 /*
-* Description: Returns the code of the series
-* Output:      std::string: Code of the series.
+* Description: Returns the code of the series (view into the global string table, no copy is made).
+* Output:      std::string_view: Code of the series.
 */
-std::string Time_Series::getSeriesCode(){
-    return series_code;
+std::string_view Time_Series::getSeriesCode(){
+    return String_Table::global().lookup(series_code_id);
+}
+
+/*
+* Description: Returns the interned id of the series code. Two series have the same code exactly when their ids are equal.
+* Output:      uint32_t: Id of the series code.
+*/
+std::uint32_t Time_Series::getSeriesCodeId(){
+    return series_code_id;
 }
 
 /*
@@ -493,6 +753,14 @@ unsigned int Time_Series::getLastIdx(){
     return last_idx;
 }  
 
+/*
+* Description: Returns the last year of the series.
+* Output:      int: last year, or FIRST_YEAR - 1 if the series is empty.
+*/
+int Time_Series::getLastYear(){
+    return (last_idx > 0) ? years[last_idx - 1] : FIRST_YEAR - 1;
+}
+
 /*
 * Description: Checks if series has valid data or not.
 * Output:      bool: flag that shows if series has valid data or not.
@@ -507,8 +775,80 @@ bool Time_Series::hasValidData(){
     return false;
 }
 
+/*
+* Description: Copies the years and values of the valid data points (in year order), skipping missing data.
+* Input:       int*: out_years, double*: out_data (each must have room for getLastIdx() elements).
+* Output:      unsigned int: number of valid data points copied.
+*/
+unsigned int Time_Series::copyValidData(int* out_years, double* out_data){
+    unsigned int count = 0;
+    for (unsigned int i = 0; i < last_idx; i++){
+        if (data[i] != MISSING_DATA_INDICATOR){
+            out_years[count] = years[i];
+            out_data[count] = data[i];
+            count++;
+        }
+    }
+    return count;
+}
+
+/*
+* Description: Accumulates the valid data points with first_year <= year <= last_year in one pass.
+*              Missing points are weighted by 0 instead of skipped, and min/max take a select, so the loop body has no branches.
+*              The loop still stays scalar: its sums and min/max are floating point reductions, which the compiler only
+*              vectorizes if it may reorder them (-ffast-math). The per-column passes of Filter_Plan vectorize at -O3 (the all
+*              target builds without -O).
+* Input:       int: first_year, int: last_year (inclusive bounds of the range).
+* Output:      Series_Stats: sums of the range, count of 0 (and min/max of +/-infinity) if it has no valid data.
+*/
+Series_Stats Time_Series::rangeStats(int first_year, int last_year){
+    Series_Stats stats = {0, 0, std::numeric_limits<double>::infinity(), -std::numeric_limits<double>::infinity(), 0, 0, 0};
+    if (last_idx == 0 || first_year > last_year){
+        return stats;
+    }
+
+    // Years are sorted, so the range is one run of indexes [begin, end).
+    int begin = returnYearIdx(first_year);
+    begin = (begin < 0) ? 0 : (years[begin] < first_year) ? begin + 1 : begin;
+    int end = returnYearIdx(last_year) + 1;
+    if (begin >= end){
+        return stats;
+    }
+
+    double origin = years[begin];
+    double count = 0, sum = 0, sum_x = 0, sum_xx = 0, sum_xy = 0;
+    double min = stats.min, max = stats.max;
+    for (int i = begin; i < end; i++){
+        double datum = data[i];
+        bool is_valid = (datum != MISSING_DATA_INDICATOR);
+        double valid = is_valid;
+        double x = (years[i] - origin) * valid;
+        double y = datum * valid;
+        // Missing points become +/-infinity, which never change the min/max.
+        double low = is_valid ? datum : stats.min;
+        double high = is_valid ? datum : stats.max;
+        count += valid;
+        sum += y;
+        sum_x += x;
+        sum_xx += x * x;
+        sum_xy += x * y;
+        min = std::min(min, low);
+        max = std::max(max, high);
+    }
+
+    stats.count = count;
+    stats.sum = sum;
+    stats.min = min;
+    stats.max = max;
+    stats.sum_x = sum_x;
+    stats.sum_xx = sum_xx;
+    stats.sum_xy = sum_xy;
+    return stats;
+}
+
 /*
 * Description: Assignment operator which copies over object attributes into new object.
+*              Arrays are not copied, both objects share them until one of them is modified (see detachBuffer).
 * Input:       Time_Series&: Reference to other object, of this class type.
 */
 Time_Series& Time_Series::operator=(const Time_Series& other){
@@ -519,40 +859,225 @@ Time_Series& Time_Series::operator=(const Time_Series& other){
     }
 
     // Copies over all the class attributes/variables
-    series_name = other.series_name;
-    series_code = other.series_code;
+    series_name_id = other.series_name_id;
+    series_code_id = other.series_code_id;
+    policy = other.policy;
     array_size  = other.array_size;
     last_idx    = other.last_idx;
 
-    // Creates new series arrays and sets them to nullptr.
-    int* new_years = nullptr;
-    double* new_data = nullptr;
+    // Takes a reference to the other arrays before releasing the old ones, in case they are the same buffer.
+    Series_Buffer* new_buffer = other.buffer;
+    if (new_buffer != nullptr){
+        new_buffer->ref_count++;
+    }
+    releaseBuffer();
+
+    buffer = new_buffer;
+    if (buffer != nullptr){
+        years = buffer->years;
+        data  = buffer->data;
+    }
+
+    // Return pointer to this.
+    return *this;
+}
+
+/*
+* Description: Allocates new (unshared) arrays of the given size.
+* Input:       size_t: size (capacity of new arrays).
+*/
+void Time_Series::allocateBuffer(std::size_t size){
+    buffer = new Series_Buffer;
+    buffer->years = new int[size];
+    buffer->data = new double[size];
+    buffer->rendered = nullptr;
+    buffer->ref_count = 1;
+
+    years = buffer->years;
+    data = buffer->data;
+}
+
+/*
+* Description: Drops this series' reference to its arrays, deleting them if no other series uses them.
+*/
+void Time_Series::releaseBuffer(){
+    dropReference(buffer);
+    buffer = nullptr;
+    years = nullptr;
+    data = nullptr;
+}
+
+/*
+* Description: Removes one reference to a buffer, deleting its arrays (and rendered output) when it was the last one.
+* Input:       Series_Buffer*: shared (buffer to release, may be nullptr).
+*/
+void Time_Series::dropReference(Series_Buffer* shared){
+    if (shared == nullptr){
+        return;
+    }
+    shared->ref_count--;
+    if (shared->ref_count == 0){
+        delete[] shared->years;
+        delete[] shared->data;
+        delete shared->rendered;
+        delete shared;
+    }
+}
+
+/*
+* Description: Called before any write to years/data. If the arrays are shared with another series (e.g. a snapshot),
+*              copies them first so the write is only seen by this series. Capacity stays the same.
+*              Also discards the cached PRINT_P2 output, since it is about to become out of date.
+*/
+void Time_Series::detachBuffer(){
+    if (buffer == nullptr){
+        return;
+    }
+    if (buffer->ref_count == 1){
+        delete buffer->rendered;
+        buffer->rendered = nullptr;
+        return;
+    }
+
+    Series_Buffer* shared = buffer;
+    shared->ref_count--;
 
-    // If other array is not empty, then copy over the values from the other array into the new one.
-    if (other.array_size > 0) {
-        new_years = new int[other.array_size];
-        new_data  = new double[other.array_size];
+    allocateBuffer(array_size);
+    for (unsigned int i = 0; i < last_idx; i++){
+        years[i] = shared->years[i];
+        data[i] = shared->data[i];
+    }
+}
 
-        for (unsigned int i = 0; i < other.last_idx; i++) {
-            new_years[i] = other.years[i];
-            new_data[i]  = other.data[i];
+/*
+* Description: Writes series as one csv row fragment: series name, series code, then one value per year from FIRST_YEAR to
+*              LAST_YEAR, or to the last year of the series if it is later (e.g. merged by REFRESH from a new year column).
+*              Years that are not stored in the series (removed or never loaded) are written as the missing data indicator.
+*              Years before FIRST_YEAR cannot be represented in the csv schema, callers check fitsCSV first.
+* Input:       Buffered_Writer&: writer (output the row is written to).
+*/
+void Time_Series::exportCSV(Buffered_Writer& writer){
+    writer.writeString(getSeriesName());
+    writer.writeChar(',');
+    writer.writeString(getSeriesCode());
+
+    // Skip any entries added before the first csv year.
+    unsigned int idx = 0;
+    while (idx < last_idx && years[idx] < FIRST_YEAR){
+        idx++;
+    }
+
+    // Years are sorted, so walk both the series and the csv columns at the same time.
+    int end_year = (getLastYear() > LAST_YEAR) ? getLastYear() : LAST_YEAR;
+    for (int year = FIRST_YEAR; year <= end_year; year++){
+        writer.writeChar(',');
+        if (idx < last_idx && years[idx] == year){
+            writer.writeDouble(data[idx]);
+            idx++;
+        } else {
+            writer.writeDouble(MISSING_DATA_INDICATOR);
         }
     }
+}
 
-    // Delete references to old arrays to prevent memory leaks
-    delete[] years;
-    delete[] data;
+/*
+* Description: Returns whether exportCSV keeps every valid data point, i.e. none is before FIRST_YEAR (the first csv column).
+* Output:      bool: false if a valid data point would be dropped.
+*/
+bool Time_Series::fitsCSV(){
+    for (unsigned int i = 0; i < last_idx && years[i] < FIRST_YEAR; i++){
+        if (data[i] != MISSING_DATA_INDICATOR){
+            return false;
+        }
+    }
+    return true;
+}
 
-    // Set old array equal to new array (temp arrays).
-    years = new_years;
-    data  = new_data;
+/*
+* Description: Writes series in binary columnar form: name, code, capacity, size, then the whole years column followed by the whole data column.
+* Input:       Buffered_Writer&: writer (output the series is written to).
+*/
+void Time_Series::exportBinary(Buffered_Writer& writer){
+    std::string_view series_name = getSeriesName();
+    std::string_view series_code = getSeriesCode();
+
+    writer.writeUInt32(series_name.size());
+    writer.writeString(series_name);
+    writer.writeUInt32(series_code.size());
+    writer.writeString(series_code);
+    writer.writeUInt64(array_size);
+    writer.writeUInt32(last_idx);
+
+    // Both columns are contiguous in memory, so each is written with a single copy.
+    writer.writeBytes(reinterpret_cast<const char*>(years), last_idx * sizeof(int));
+    writer.writeBytes(reinterpret_cast<const char*>(data), last_idx * sizeof(double));
+}
 
-    // Return pointer to this.
-    return *this;
+/*
+* Description: Reads a series written by exportBinary, replacing the current contents. Capacity is restored as written.
+* Input:       std::ifstream&: file (positioned at the start of a series).
+* Output:      bool: false if the file ended early or the sizes are inconsistent (the series is then empty).
+*/
+bool Time_Series::importBinary(std::ifstream& file){
+    releaseBuffer();
+    array_size = 0;
+    last_idx = 0;
+
+    std::string series_name;
+    std::string series_code;
+    std::uint64_t capacity = 0;
+    std::uint32_t count = 0;
+    if (!readBinaryString(file, series_name) || !readBinaryString(file, series_code)
+        || !file.read(reinterpret_cast<char*>(&capacity), sizeof(capacity))
+        || !file.read(reinterpret_cast<char*>(&count), sizeof(count))
+        || count > capacity){
+        return false;
+    }
+
+    series_name_id = String_Table::global().intern(series_name);
+    series_code_id = String_Table::global().intern(series_code);
+
+    array_size = (capacity < static_cast<std::uint64_t>(MIN_ARRAY_SIZE)) ? MIN_ARRAY_SIZE : capacity;
+    allocateBuffer(array_size);
+    if (!file.read(reinterpret_cast<char*>(years), count * sizeof(int))
+        || !file.read(reinterpret_cast<char*>(data), count * sizeof(double))){
+        return false;
+    }
+    last_idx = count;
+    return true;
+}
+
+/*
+* Description: Reads a string written as a 32 bit length followed by its characters.
+* Input:       std::ifstream&: file, std::string&: str (receives the string).
+* Output:      bool: false if the file ended early.
+*/
+bool Time_Series::readBinaryString(std::ifstream& file, std::string& str){
+    std::uint32_t length = 0;
+    if (!file.read(reinterpret_cast<char*>(&length), sizeof(length))){
+        return false;
+    }
+    str.resize(length);
+    return static_cast<bool>(file.read(&str[0], length));
+}
+
+/*
+* Description: Returns the number of heap bytes used by the series arrays (whole capacity) and their cached PRINT_P2 output.
+*              Arrays shared with a snapshot are counted for every series that refers to them.
+* Output:      size_t: bytes in use.
+*/
+std::size_t Time_Series::memoryUsage(){
+    if (buffer == nullptr){
+        return 0;
+    }
+    std::size_t bytes = sizeof(Series_Buffer) + array_size * (sizeof(int) + sizeof(double));
+    if (buffer->rendered != nullptr){
+        bytes += sizeof(std::string) + buffer->rendered->capacity();
+    }
+    return bytes;
 }
 
 
 Time_Series::~Time_Series(){
-    delete[] years;
-    delete[] data;
+    releaseBuffer();
 }
\ No newline at end of file
@@ -2,10 +2,35 @@
 #include <fstream>
 #include <string>
 #include <sstream>
+#include <string_view>
+#include <cstdint>
+#include "Buffered_Writer.hpp"
+#include "String_Table.hpp"
+#include "Resize_Policy.hpp"
 
 #ifndef TIME_SERIES_H
 #define TIME_SERIES_H
 
+// Years/data arrays of a series, shared between copies of the series until one of them is modified (copy-on-write).
+// Also caches the PRINT_P2 output of those arrays, which is dropped on the first write to them.
+struct Series_Buffer {
+    int* years;
+    double* data;
+    std::string* rendered;
+    unsigned int ref_count;
+};
+
+// Sums over the valid data points of a series within a range of years, enough to derive its mean, min, max and best fit slope.
+// sum_x/sum_xx/sum_xy use years relative to the first year of the range, which keeps them small.
+struct Series_Stats {
+    double count;
+    double sum;
+    double min;
+    double max;
+    double sum_x;
+    double sum_xx;
+    double sum_xy;
+};
 
 class Time_Series {
 private:
@@ -14,41 +39,71 @@ private:
     int LAST_YEAR;
     double MISSING_DATA_INDICATOR;
 
-    std::string series_name;
-    std::string series_code;
+    // Ids of the series name/code in String_Table::global().
+    std::uint32_t series_name_id;
+    std::uint32_t series_code_id;
 
+    Series_Buffer* buffer;
     int* years;
     double* data;
 
     std::size_t array_size;
     unsigned int last_idx;
 
+    // Picks the capacity of the arrays (see Resize_Policy), set by the country the series belongs to.
+    const Resize_Policy* policy;
+
+    bool resizeForWrite(unsigned int passes);
+    void allocateBuffer(std::size_t size);
+    void releaseBuffer();
+    void detachBuffer();
+    static void dropReference(Series_Buffer* shared);
+
 public:
     Time_Series();
+    Time_Series(const Time_Series& other);
     ~Time_Series();
     
     void load(std::istringstream& input_line);
     bool addSeriesElement(int year, double datum);
     void addSeriesLoad(int year, double datum);
+    unsigned int mergeFileYears(Time_Series& other, int after_year);
     void removeSeriesElement(int idx);
     bool checkAndResizeSeries();
     void resizeSeries(size_t& new_size);
+    bool compact();
+    bool shrinkToFit();
+    void setPolicy(const Resize_Policy* new_policy);
     void print();
-    void add(int year, double datum);
-    void update(int year, double datum);
+    bool add(int year, double datum);
+    bool update(int year, double datum);
+    void mergeElements(int* in_years, double* in_data, unsigned int count, bool is_update, bool* results);
     double mean();
     void mean_p1();
     bool is_monotonic();
     bool best_fit(double &m, double &b);
+    bool fitLine(double &m, double &b);
     void insertSeriesElement(int year, double data, size_t element_idx);
     int returnYearIdx(int year);
 
 // P2 New Methods:
-    std::string getSeriesName();
-    std::string getSeriesCode();
+    std::string_view getSeriesName();
+    std::string_view getSeriesCode();
+    std::uint32_t getSeriesCodeId();
     std::size_t getArraySize();
     unsigned int getLastIdx(); 
+    int getLastYear();
     bool hasValidData();   
+    unsigned int copyValidData(int* out_years, double* out_data);
+    Series_Stats rangeStats(int first_year, int last_year);
     Time_Series& operator=(const Time_Series& other);
+
+// Export Methods:
+    void exportCSV(Buffered_Writer& writer);
+    bool fitsCSV();
+    void exportBinary(Buffered_Writer& writer);
+    bool importBinary(std::ifstream& file);
+    static bool readBinaryString(std::ifstream& file, std::string& str);
+    std::size_t memoryUsage();
 };
 #endif
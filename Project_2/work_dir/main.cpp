@@ -2,43 +2,155 @@
 #include <fstream>
 #include <string>
 #include <sstream>
+#include <unistd.h>
+#include "Command_Buffer.hpp"
 #include "Country_Data.hpp"
+#include "Country_Loader.hpp"
+#include "Country_Cache.hpp"
+#include "Data_Catalog.hpp"
 
 int main(){
     
     Country_Data country_data;
-    std::string input = "";
-    while (std::cin >> input && input != "EXIT"){
+    Country_Loader loader;
+    Country_Cache cache;
+
+    // Commands are parsed as they arrive. A LOAD_P2 that already arrived behind the running command is prefetched.
+    Command_Buffer command_buffer(STDIN_FILENO);
+    std::istream input(&command_buffer);
+
+    std::string next_country = "";
+    if (input.peek() != EOF){
+        next_country = command_buffer.nextLoadTarget();
+    }
+    if (next_country != ""){
+        loader.prefetch(next_country);
+    }
+
+    std::string command = "";
+    while (input >> command && command != "EXIT"){
         std::string country_name;
         std::string series_code;
         int year = 0;
         double datum = 0;
-        if (input == "LOAD_P2"){
-            std::cin >> country_name;
-            country_data.load(country_name);
-        } else if (input == "UPDATE_P2"){
-            std::cin >> series_code;
-            std::cin >> year;
-            std::cin >> datum;
+        if (command == "LOAD_P2"){
+            input >> country_name;
+            cache.load(country_name, country_data, loader);
+
+            // Starts reading the country of the next LOAD_P2 while the commands in between run.
+            next_country = command_buffer.nextLoadTarget();
+            if (next_country != ""){
+                loader.prefetch(next_country);
+            }
+        } else if (command == "UPDATE_P2"){
+            input >> series_code;
+            input >> year;
+            input >> datum;
             country_data.update(series_code, year, datum);
-        } else if (input == "PRINT_P2"){
-            std::cin >> series_code;
+        } else if (command == "PRINT_P2"){
+            input >> series_code;
             country_data.printSeries(series_code);
-        } else if (input == "LIST_P2"){
+        } else if (command == "LIST_P2"){
             country_data.listSeries();
-        } else if (input == "ADD_P2"){
-            std::cin >> series_code;
-            std::cin >> year;
-            std::cin >> datum;
+        } else if (command == "ADD_P2"){
+            input >> series_code;
+            input >> year;
+            input >> datum;
             country_data.addSeriesElement(series_code, year, datum);
-        } else if (input == "DELETE_P2"){
-            std::cin >> series_code;
+        } else if (command == "DELETE_P2"){
+            input >> series_code;
             country_data.deleteSeries(series_code);
-        } else if (input == "BIGGEST_P2"){
+        } else if (command == "BIGGEST_P2"){
             country_data.seriesWithBiggestMean();
-        } else if (input == "TS_P2"){
-            std::cin >> series_code;
+        } else if (command == "TS_P2"){
+            input >> series_code;
             country_data.seriesSizeCapacity(series_code);
+        } else if (command == "EXPORT"){
+            std::string format;
+            std::string file_name;
+            input >> format;
+            input >> file_name;
+            country_data.exportData(format, file_name);
+        } else if (command == "TOP_K"){
+            std::string metric;
+            int k = 0;
+            input >> metric;
+            input >> k;
+            country_data.topSeries(metric, k);
+        } else if (command == "CORR"){
+            int k = 0;
+            input >> series_code;
+            input >> k;
+            country_data.correlateSeries(series_code, k);
+        } else if (command == "CORR_MATRIX"){
+            std::string file_name;
+            input >> file_name;
+            country_data.exportCorrelation(file_name);
+        } else if (command == "SNAPSHOT"){
+            country_data.snapshot();
+        } else if (command == "ROLLBACK"){
+            country_data.rollback();
+        } else if (command == "BULK_ADD" || command == "BULK_UPDATE"){
+            // Pairs run until the end of the line.
+            std::string pairs_line;
+            input >> series_code;
+            std::getline(input, pairs_line);
+            std::istringstream pairs(pairs_line);
+            country_data.bulkMerge(series_code, pairs, command == "BULK_UPDATE");
+        } else if (command == "FIND"){
+            // Query runs until the end of the line.
+            std::string field;
+            std::string query_line;
+            input >> field;
+            std::getline(input, query_line);
+            std::istringstream query(query_line);
+            country_data.findSeries(field, query);
+        } else if (command == "FILTER"){
+            std::string query_line;
+            std::getline(input, query_line);
+            std::istringstream query(query_line);
+            country_data.filterSeries(query);
+        } else if (command == "PREFETCH"){
+            input >> country_name;
+            if (loader.prefetch(country_name)){
+                std::cout << "success" << std::endl;
+            } else {
+                std::cout << "failure" << std::endl;
+            }
+        } else if (command == "CACHE_BUDGET"){
+            std::size_t bytes = 0;
+            input >> bytes;
+            cache.setBudget(bytes, country_data);
+        } else if (command == "CACHE_STATS"){
+            // Optional COUNTS runs until the end of the line.
+            std::string mode_line;
+            std::string mode;
+            std::getline(input, mode_line);
+            std::istringstream mode_stream(mode_line);
+            mode_stream >> mode;
+            cache.printStats(country_data, mode == "COUNTS");
+        } else if (command == "ADD_FILE" || command == "DROP_FILE"){
+            std::string file_name;
+            input >> file_name;
+            bool success = (command == "ADD_FILE") ? Data_Catalog::shared().addFile(file_name)
+                                                   : Data_Catalog::shared().dropFile(file_name);
+            if (success){
+                std::cout << "success" << std::endl;
+            } else {
+                std::cout << "failure" << std::endl;
+            }
+        } else if (command == "LIST_FILES"){
+            Data_Catalog::shared().listFiles();
+        } else if (command == "REFRESH"){
+            country_data.refresh();
+        } else if (command == "POLICY"){
+            std::string policy_name;
+            input >> policy_name;
+            country_data.setPolicy(policy_name);
+        } else if (command == "COMPACT"){
+            country_data.resizeCommand(false);
+        } else if (command == "SHRINK_TO_FIT"){
+            country_data.resizeCommand(true);
         }
     }
 }
\ No newline at end of file
@@ -5,6 +5,7 @@ SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
 PROGRAM="$SCRIPT_DIR/a.out"
 IN_DIR="$SCRIPT_DIR/test_files/input"
 OUT_DIR="$SCRIPT_DIR/test_files/output"
+DATA_DIR="$SCRIPT_DIR/test_files/data"
 
 SHOW_ALL=0
 if [[ $# -gt 0 && "$1" == "--show-all" ]]; then
@@ -100,6 +101,21 @@ run_one_test() {
     return 1
   fi
 
+  # Files the test writes are test_files/data/out_*. Each one with an expected copy in the output dir, named
+  # <test>.<file> (e.g. test24.out_corr.csv), must match it exactly. All of them are removed after the test.
+  local written_ok=1
+  local exp_written
+  for exp_written in "$OUT_DIR/$name".out_*; do
+    [[ -e "$exp_written" ]] || continue
+    local written="$DATA_DIR/${exp_written#"$OUT_DIR/$name."}"
+    if ! cmp -s "$exp_written" "$written"; then
+      echo "FAIL  $name  ($(basename "$written") differs from $(basename "$exp_written"))"
+      written_ok=0
+    fi
+  done
+  rm -f "$DATA_DIR"/out_*
+  [[ $written_ok -eq 1 ]] || return 1
+
   normalize_file "$exp_file"   > "$expected_norm"
   normalize_file "$actual_raw" > "$actual_norm"
 